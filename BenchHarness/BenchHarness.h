@@ -0,0 +1,74 @@
+#pragma once
+#include <Windows.h>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+# BenchHarness
+
+ġũ  ϴ   Դϴ.
+
+double elapsedSec = RunBenchThreads(threadNum,
+	[&](UINT32 threadIdx) { ... },		//   غ ۾
+	[&](UINT32 threadIdx) { ... });		//  ۾
+
+-  尡 prepare ġ غǸ ÿ work ϸ
+  ۺ  尡   ð() QueryPerformanceCounter 
+- onStart     忡   ȣ
+- onWait ϸ   work    忡 ݺ ȣ(  ø 뵵)
+  nullptr̸   ٷ joinϿ 
+*/
+
+template <class Prepare, class Work, class OnStart, class OnWait>
+inline double RunBenchThreads(UINT32 threadNum, Prepare prepare, Work work, OnStart onStart, OnWait onWait)
+{
+	volatile LONG readyCnt = 0;
+	volatile LONG isStart = 0;
+	volatile LONG doneCnt = 0;
+	std::vector<std::thread> threads;
+	threads.reserve(threadNum);
+	for (UINT32 threadIdx = 0; threadIdx < threadNum; threadIdx++)
+	{
+		threads.emplace_back([&, threadIdx]()
+		{
+			prepare(threadIdx);
+
+			InterlockedIncrement(&readyCnt);
+			while (isStart == 0)
+				YieldProcessor();
+
+			work(threadIdx);
+			InterlockedIncrement(&doneCnt);
+		});
+	}
+
+	//  尡 غǸ  
+	while (readyCnt != (LONG)threadNum)
+		YieldProcessor();
+	onStart();
+
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER start;
+	LARGE_INTEGER end;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&start);
+	InterlockedExchange(&isStart, 1);
+	if constexpr (!std::is_same_v<OnWait, std::nullptr_t>)
+	{
+		while (doneCnt != (LONG)threadNum)
+			onWait();
+	}
+	for (std::thread& th : threads)
+		th.join();
+	QueryPerformanceCounter(&end);
+
+	return (double)(end.QuadPart - start.QuadPart) / frequency.QuadPart;
+}
+
+template <class Prepare, class Work>
+inline double RunBenchThreads(UINT32 threadNum, Prepare prepare, Work work)
+{
+	return RunBenchThreads(threadNum, prepare, work, []() {}, nullptr);
+}
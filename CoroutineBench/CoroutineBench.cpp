@@ -0,0 +1,198 @@
+/*
+# CoroutineBench
+
+ڷƾ (spawn) Ϸ ó
+⺻ operator new Ӱ PooledPromise(CoroutineFramePool)   մϴ.
+
+CoroutineBench [threadNum] [taskNumPerThread]
+	threadNum			:   (⺻ 4)
+	taskNumPerThread	: 帶 ϰ Ϸų ڷƾ (⺻ 2000000)
+
+-   BATCH_TASK_NUM ڷƾ      resumeϿ ߴ  Ű
+  ٽ  resumeϿ ϷŴ(ÿ ִ  BATCH_TASK_NUM)
+- cross-thread ߴ  Ų ڷƾ  忡 Ѱ  尡 resumeϿ ϷŴ
+     ̾ ־    尡 ƴ 忡 
+  (threadNum 1̸ ڱ ڽſ ѱǷ    )
+-  ũ ߴ  Ѿ ϴ  迭 ũ ( / ߰ / ū Ŷ)
+-   Mtasks/sec( + ϷḦ 1ȸ )
+*/
+#define MEMORYPOOL_MODE_RELEASE
+#include "../MemoryPoolTLS/CoroutineFramePool.h"
+#include "../BenchHarness/BenchHarness.h"
+#include <coroutine>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <vector>
+
+#define DEFAULT_THREAD_NUM	4
+#define DEFAULT_TASK_NUM	2000000
+#define BATCH_TASK_NUM		64
+#define WAIT_SPIN_COUNT		64
+
+///////////////////////////////////////////////////////////////////////////////////////
+/* Task */
+struct HeapPromise
+{
+};
+
+template <class Promise>
+struct Task
+{
+	struct promise_type : Promise
+	{
+		Task get_return_object() { return Task{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+	std::coroutine_handle<promise_type>	_handle;
+};
+
+// LocalSizeŭ  迭 ߴ  Ѿ Ƿ ӿ Ե
+template <class Promise, size_t LocalSize>
+static Task<Promise> Work(UINT64* pSum)
+{
+	BYTE local[LocalSize];
+	local[0] = 1;
+	local[LocalSize - 1] = 1;
+	co_await std::suspend_always{};
+	*pSum += local[0] + local[LocalSize - 1];
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//   ڷƾ  
+struct alignas(64) HANDOFF
+{
+	std::coroutine_handle<>	_handles[BATCH_TASK_NUM];
+	UINT64					_sum;		// Ѱܹ 常 
+	volatile LONG			_isFull;
+};
+
+// ٸ 尡  ٲ  , 尡 ھ  Ƶ ǵ    纸
+static void WaitFor(volatile LONG* pFlag, LONG value)
+{
+	for (UINT32 spinCnt = 0; *pFlag != value; spinCnt++)
+	{
+		if (spinCnt < WAIT_SPIN_COUNT)
+			YieldProcessor();
+		else
+			SwitchToThread();
+	}
+}
+
+template <class Promise, size_t LocalSize>
+static double RunLocal(UINT32 threadNum, UINT64 taskNum)
+{
+	std::vector<UINT64> sums(threadNum);
+	double elapsedSec = RunBenchThreads(threadNum,
+		[&](UINT32 threadIdx)
+		{
+			// ù Chunk Ҵ  
+			Task<Promise> task = Work<Promise, LocalSize>(&sums[threadIdx]);
+			task._handle.resume();
+			task._handle.resume();
+		},
+		[&](UINT32 threadIdx)
+		{
+			std::coroutine_handle<> handles[BATCH_TASK_NUM];
+			UINT64 sum = 0;
+			for (UINT64 i = 0; i < taskNum; i += BATCH_TASK_NUM)
+			{
+				for (UINT32 j = 0; j < BATCH_TASK_NUM; j++)
+					handles[j] = Work<Promise, LocalSize>(&sum)._handle;
+				for (UINT32 j = 0; j < BATCH_TASK_NUM; j++)
+					handles[j].resume();
+				for (UINT32 j = 0; j < BATCH_TASK_NUM; j++)
+					handles[j].resume();
+			}
+			sums[threadIdx] += sum;
+		});
+
+	UINT64 totalTaskNum = (taskNum + BATCH_TASK_NUM - 1) / BATCH_TASK_NUM * BATCH_TASK_NUM * threadNum;
+	return elapsedSec > 0 ? (double)totalTaskNum / elapsedSec / 1000000.0 : 0.0;
+}
+
+template <class Promise, size_t LocalSize>
+static double RunCross(UINT32 threadNum, UINT64 taskNum)
+{
+	std::vector<HANDOFF> handoffs(threadNum);
+	for (HANDOFF& handoff : handoffs)
+	{
+		handoff._sum = 0;
+		handoff._isFull = 0;
+	}
+
+	double elapsedSec = RunBenchThreads(threadNum,
+		[&](UINT32 threadIdx)
+		{
+			// ù Chunk Ҵ  
+			Task<Promise> task = Work<Promise, LocalSize>(&handoffs[threadIdx]._sum);
+			task._handle.resume();
+			task._handle.resume();
+		},
+		[&](UINT32 threadIdx)
+		{
+			// ڽ  ڷƾ outbox  忡 ѱ  尡 ѱ ڷƾ inbox Ϸ
+			HANDOFF& outbox = handoffs[threadIdx];
+			HANDOFF& inbox = handoffs[(threadIdx + threadNum - 1) % threadNum];
+			for (UINT64 i = 0; i < taskNum; i += BATCH_TASK_NUM)
+			{
+				WaitFor(&outbox._isFull, 0);
+				for (UINT32 j = 0; j < BATCH_TASK_NUM; j++)
+					outbox._handles[j] = Work<Promise, LocalSize>(&outbox._sum)._handle;
+				for (UINT32 j = 0; j < BATCH_TASK_NUM; j++)
+					outbox._handles[j].resume();
+				InterlockedExchange(&outbox._isFull, 1);
+
+				WaitFor(&inbox._isFull, 1);
+				for (UINT32 j = 0; j < BATCH_TASK_NUM; j++)
+					inbox._handles[j].resume();
+				InterlockedExchange(&inbox._isFull, 0);
+			}
+		});
+
+	UINT64 totalTaskNum = (taskNum + BATCH_TASK_NUM - 1) / BATCH_TASK_NUM * BATCH_TASK_NUM * threadNum;
+	return elapsedSec > 0 ? (double)totalTaskNum / elapsedSec / 1000000.0 : 0.0;
+}
+
+template <class Promise, size_t LocalSize, bool IsCrossThread>
+static double Run(UINT32 threadNum, UINT64 taskNum)
+{
+	if constexpr (IsCrossThread)
+		return RunCross<Promise, LocalSize>(threadNum, taskNum);
+	else
+		return RunLocal<Promise, LocalSize>(threadNum, taskNum);
+}
+
+template <size_t LocalSize, bool IsCrossThread = false>
+static void PrintRow(const char* name, UINT32 threadNum, UINT64 taskNum)
+{
+	double heap = Run<HeapPromise, LocalSize, IsCrossThread>(threadNum, taskNum);
+	double pooled = Run<PooledPromise, LocalSize, IsCrossThread>(threadNum, taskNum);
+	printf("%-20s %14.2f %14.2f %10.2fx\n", name, heap, pooled, heap > 0 ? pooled / heap : 0.0);
+}
+
+int main(int argc, char* argv[])
+{
+	UINT32 threadNum = argc > 1 ? (UINT32)strtoul(argv[1], nullptr, 10) : DEFAULT_THREAD_NUM;
+	UINT64 taskNum = argc > 2 ? strtoull(argv[2], nullptr, 10) : DEFAULT_TASK_NUM;
+	if (threadNum == 0 || taskNum == 0)
+	{
+		printf("Usage: %s [threadNum] [taskNumPerThread]\n", argv[0]);
+		return 1;
+	}
+
+	printf("Threads         : %u\n", threadNum);
+	printf("Tasks per thread: %llu (spawn + complete)\n", taskNum);
+	printf("Throughput      : Mtasks/sec\n\n");
+	printf("%-20s %14s %14s %11s\n", "Frame", "operator new", "PooledPromise", "Speedup");
+	PrintRow<32>("small (~128B)", threadNum, taskNum);
+	PrintRow<COROUTINE_FRAME_MAX_SIZE / 4>("medium (~1KB)", threadNum, taskNum);
+	PrintRow<COROUTINE_FRAME_MAX_SIZE * 3 / 4>("large (~3KB)", threadNum, taskNum);
+	PrintRow<32, true>("small cross-thread", threadNum, taskNum);
+	PrintRow<COROUTINE_FRAME_MAX_SIZE / 4, true>("medium cross-thread", threadNum, taskNum);
+	PrintRow<COROUTINE_FRAME_MAX_SIZE * 3 / 4, true>("large cross-thread", threadNum, taskNum);
+	return 0;
+}
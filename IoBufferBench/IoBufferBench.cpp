@@ -0,0 +1,251 @@
+/*
+# IoBufferBench
+
+  IoRing READ_FIXED  
+- IoBufferPoolTLS ۸ RegisterIoRing ϰ GetBufferRef ϴ 
+- new[] Ҵ   ۸ IoRingBufferRefFromPointer ϴ 
+ ó մϴ(Windows 11 ̻).
+
+IoBufferBench [fileSizeMB] [queueDepth] [readNum]
+	fileSizeMB	:  ӽ  ũ(⺻ 256), ĳõ    ޸𸮺 ۰ 
+	queueDepth	:   ϴ б û   (⺻ 32)
+	readNum		:   б û (⺻ 200000)
+
+- ĳõ :    ü   о ý ĳÿ ÷ΰ Ϲ   
+  ũ ġ Ƿ û ۸ װ ϴ   ̰ 巯
+- ĳ  : FILE_FLAG_NO_BUFFERING   û ۷  DMAǵ 
+  ũ ӵ  κ ϹǷ 
+-   ۵ new[]   Ͽ   
+- б ġ  ũ     queueDepth    ϷǸ ٽ 
+-   Kops/sec MB/sec
+*/
+#define MEMORYPOOL_MODE_RELEASE
+#define IOBUFFERPOOL_USE_IORING
+#include "../MemoryPoolTLS/IoBufferPoolTLS.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#define DEFAULT_FILE_SIZE_MB	256
+#define DEFAULT_QUEUE_DEPTH		32
+#define DEFAULT_READ_NUM		200000
+#define BENCH_BUFFER_SIZE		IO_BUFFER_ALIGN
+#define BENCH_FILE_NAME			L"IoBufferBench.tmp"
+
+typedef IoBufferPoolTLS<BENCH_BUFFER_SIZE> BenchBufferPool;
+
+///////////////////////////////////////////////////////////////////////////////////////
+/* Buffer */
+class RegisteredBuffer
+{
+public:
+	RegisteredBuffer(HIORING ioRing, UINT32 bufferNum) :_pool(bufferNum), _bufferNum(bufferNum)
+	{
+		HRESULT hr = _pool.RegisterIoRing(ioRing);
+		if (FAILED(hr))
+			throw hr;
+		_buffers = new char*[bufferNum];
+		for (UINT32 i = 0; i < bufferNum; i++)
+			_buffers[i] = _pool.Alloc();
+	}
+	~RegisteredBuffer()
+	{
+		for (UINT32 i = 0; i < _bufferNum; i++)
+			_pool.Free(_buffers[i]);
+		delete[] _buffers;
+	}
+	IORING_BUFFER_REF GetRef(UINT32 bufferIdx) { return _pool.GetBufferRef(_buffers[bufferIdx]); }
+private:
+	BenchBufferPool	_pool;
+	char**			_buffers;
+	UINT32			_bufferNum;
+};
+
+class UnregisteredBuffer
+{
+public:
+	UnregisteredBuffer(HIORING ioRing, UINT32 bufferNum) :_bufferNum(bufferNum)
+	{
+		_buffers = new char*[bufferNum];
+		for (UINT32 i = 0; i < bufferNum; i++)
+			_buffers[i] = new (std::align_val_t(IO_BUFFER_ALIGN)) char[BENCH_BUFFER_SIZE];
+	}
+	~UnregisteredBuffer()
+	{
+		for (UINT32 i = 0; i < _bufferNum; i++)
+			operator delete[](_buffers[i], std::align_val_t(IO_BUFFER_ALIGN));
+		delete[] _buffers;
+	}
+	IORING_BUFFER_REF GetRef(UINT32 bufferIdx) { return IoRingBufferRefFromPointer(_buffers[bufferIdx]); }
+private:
+	char**	_buffers;
+	UINT32	_bufferNum;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+static bool CreateBenchFile(UINT64 fileSize)
+{
+	HANDLE hFile = CreateFileW(BENCH_FILE_NAME, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	const DWORD writeSize = 1024 * 1024;
+	char* pData = new char[writeSize];
+	for (DWORD i = 0; i < writeSize; i++)
+		pData[i] = (char)i;
+
+	DWORD written;
+	bool isSuccess = true;
+	for (UINT64 offset = 0; offset < fileSize && isSuccess; offset += writeSize)
+		isSuccess = WriteFile(hFile, pData, writeSize, &written, NULL) && written == writeSize;
+
+	delete[] pData;
+	CloseHandle(hFile);
+	return isSuccess;
+}
+
+//  ü о ý ĳÿ ÷
+static bool WarmFileCache(UINT64 fileSize)
+{
+	HANDLE hFile = CreateFileW(BENCH_FILE_NAME, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	const DWORD readSize = 1024 * 1024;
+	char* pData = new char[readSize];
+	DWORD read;
+	bool isSuccess = true;
+	for (UINT64 offset = 0; offset < fileSize && isSuccess; offset += readSize)
+		isSuccess = ReadFile(hFile, pData, readSize, &read, NULL) && read == readSize;
+
+	delete[] pData;
+	CloseHandle(hFile);
+	return isSuccess;
+}
+
+// ϸ  ȯ
+template <class Buffer>
+static double Run(bool isCached, UINT64 fileSize, UINT32 queueDepth, UINT64 readNum)
+{
+	DWORD flags = isCached ? FILE_ATTRIBUTE_NORMAL : FILE_FLAG_NO_BUFFERING;
+	HANDLE hFile = CreateFileW(BENCH_FILE_NAME, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, flags, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return -1.0;
+
+	HIORING ioRing;
+	IORING_CREATE_FLAGS ringFlags = { IORING_CREATE_REQUIRED_FLAGS_NONE, IORING_CREATE_ADVISORY_FLAGS_NONE };
+	HRESULT hr = CreateIoRing(IORING_VERSION_3, ringFlags, queueDepth, queueDepth * 2, &ioRing);
+	if (FAILED(hr))
+	{
+		CloseHandle(hFile);
+		return -1.0;
+	}
+
+	double result = -1.0;
+	try
+	{
+		Buffer buffer(ioRing, queueDepth);
+		IORING_HANDLE_REF fileRef = IoRingHandleRefFromHandle(hFile);
+		UINT64 blockNum = fileSize / BENCH_BUFFER_SIZE;
+		UINT64 blockIdx = 0;
+		UINT64 completedNum = 0;
+		UINT32 submitted;
+		IORING_CQE cqe;
+
+		LARGE_INTEGER frequency;
+		LARGE_INTEGER start;
+		LARGE_INTEGER end;
+		QueryPerformanceFrequency(&frequency);
+		QueryPerformanceCounter(&start);
+		while (completedNum < readNum && SUCCEEDED(hr))
+		{
+			UINT32 batchNum = readNum - completedNum < queueDepth ? (UINT32)(readNum - completedNum) : queueDepth;
+			for (UINT32 i = 0; i < batchNum && SUCCEEDED(hr); i++)
+			{
+				hr = BuildIoRingReadFile(ioRing, fileRef, buffer.GetRef(i), BENCH_BUFFER_SIZE,
+					blockIdx * BENCH_BUFFER_SIZE, i, IOSQE_FLAGS_NONE);
+				blockIdx = (blockIdx + 1) % blockNum;
+			}
+			if (SUCCEEDED(hr))
+				hr = SubmitIoRing(ioRing, batchNum, INFINITE, &submitted);
+
+			//  û  Ϸ  
+			for (UINT32 i = 0; i < batchNum && SUCCEEDED(hr); )
+			{
+				hr = PopIoRingCompletion(ioRing, &cqe);
+				if (hr == S_FALSE)
+				{
+					hr = SubmitIoRing(ioRing, 1, INFINITE, &submitted);
+					continue;
+				}
+				if (SUCCEEDED(hr))
+					hr = cqe.ResultCode;
+				i++;
+			}
+			completedNum += batchNum;
+		}
+		QueryPerformanceCounter(&end);
+
+		double elapsedSec = (double)(end.QuadPart - start.QuadPart) / frequency.QuadPart;
+		if (SUCCEEDED(hr) && elapsedSec > 0)
+			result = (double)readNum / elapsedSec;
+	}
+	catch (HRESULT)
+	{
+	}
+
+	CloseIoRing(ioRing);
+	CloseHandle(hFile);
+	return result;
+}
+
+static void PrintResult(const char* name, double opsPerSec)
+{
+	if (opsPerSec < 0)
+		printf("%-24s %14s %14s\n", name, "failed", "-");
+	else
+		printf("%-24s %14.2f %14.2f\n", name, opsPerSec / 1000.0, opsPerSec * BENCH_BUFFER_SIZE / (1024.0 * 1024.0));
+}
+
+int main(int argc, char* argv[])
+{
+	UINT64 fileSizeMB = argc > 1 ? strtoull(argv[1], nullptr, 10) : DEFAULT_FILE_SIZE_MB;
+	UINT32 queueDepth = argc > 2 ? (UINT32)strtoul(argv[2], nullptr, 10) : DEFAULT_QUEUE_DEPTH;
+	UINT64 readNum = argc > 3 ? strtoull(argv[3], nullptr, 10) : DEFAULT_READ_NUM;
+	if (fileSizeMB == 0 || queueDepth == 0 || readNum == 0)
+	{
+		printf("Usage: %s [fileSizeMB] [queueDepth] [readNum]\n", argv[0]);
+		return 1;
+	}
+
+	UINT64 fileSize = fileSizeMB * 1024 * 1024;
+	if (!CreateBenchFile(fileSize))
+	{
+		printf("Failed to create %ls (%u)\n", BENCH_FILE_NAME, GetLastError());
+		return 1;
+	}
+
+	printf("File size       : %llu MB\n", fileSizeMB);
+	printf("Queue depth     : %u\n", queueDepth);
+	printf("Reads           : %llu x %u byte\n\n", readNum, BENCH_BUFFER_SIZE);
+	printf("%-24s %14s %14s\n", "Buffer", "Kops/sec", "MB/sec");
+
+	printf("[cached file]\n");
+	if (!WarmFileCache(fileSize))
+	{
+		printf("Failed to read %ls (%u)\n", BENCH_FILE_NAME, GetLastError());
+		DeleteFileW(BENCH_FILE_NAME);
+		return 1;
+	}
+	PrintResult("new[] (unregistered)", Run<UnregisteredBuffer>(true, fileSize, queueDepth, readNum));
+	PrintResult("IoBufferPoolTLS (fixed)", Run<RegisteredBuffer>(true, fileSize, queueDepth, readNum));
+
+	printf("[unbuffered file]\n");
+	// ù  ġ غ   ʵ   о
+	Run<UnregisteredBuffer>(false, fileSize, queueDepth, queueDepth);
+	PrintResult("new[] (unregistered)", Run<UnregisteredBuffer>(false, fileSize, queueDepth, readNum));
+	PrintResult("IoBufferPoolTLS (fixed)", Run<RegisteredBuffer>(false, fileSize, queueDepth, readNum));
+
+	DeleteFileW(BENCH_FILE_NAME);
+	return 0;
+}
@@ -0,0 +1,132 @@
+/*
+# LockFreeBench
+
+LockFreeStack/LockFreeQueue mutex + std::deque   ó
+1 ~ 64 忡 մϴ.
+
+LockFreeBench [opNumPerThread] [initNodeNum]
+	opNumPerThread	: 帶  Push/Pop  (⺻ 1000000)
+	initNodeNum		:   ̸ ־δ  (⺻ 10000)
+
+-   Push  Pop ݺϸ Push/Pop   1ȸ 
+-   ̳ʸ  ϰ  尡 غ   
+-   Mops/sec
+*/
+#define MEMORYPOOL_MODE_RELEASE
+#include "../MemoryPoolTLS/LockFreeStack.h"
+#include "../MemoryPoolTLS/LockFreeQueue.h"
+#include "../BenchHarness/BenchHarness.h"
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+
+#define DEFAULT_OP_NUM		1000000
+#define DEFAULT_INIT_NODE	10000
+#define MAX_THREAD_NUM		64
+
+///////////////////////////////////////////////////////////////////////////////////////
+/* Container */
+class StackLockFree
+{
+public:
+	StackLockFree(UINT64 initNodeNum) :_stack(initNodeNum) {}
+	bool Push(UINT64 data) { return _stack.Push(data); }
+	bool Pop(UINT64* pDestData) { return _stack.Pop(pDestData); }
+private:
+	LockFreeStack<UINT64> _stack;
+};
+
+class QueueLockFree
+{
+public:
+	QueueLockFree(UINT64 initNodeNum) :_queue(initNodeNum) {}
+	bool Push(UINT64 data) { return _queue.Enqueue(data); }
+	bool Pop(UINT64* pDestData) { return _queue.Dequeue(pDestData); }
+private:
+	LockFreeQueue<UINT64> _queue;
+};
+
+//  , isLifo true , false ť 
+template <bool isLifo>
+class DequeMutex
+{
+public:
+	DequeMutex(UINT64 initNodeNum) {}
+	bool Push(UINT64 data)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_deque.push_back(data);
+		return true;
+	}
+	bool Pop(UINT64* pDestData)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_deque.empty())
+			return false;
+		if (isLifo)
+		{
+			*pDestData = _deque.back();
+			_deque.pop_back();
+		}
+		else
+		{
+			*pDestData = _deque.front();
+			_deque.pop_front();
+		}
+		return true;
+	}
+private:
+	std::mutex			_mutex;
+	std::deque<UINT64>	_deque;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+template <class Container>
+static double Run(UINT32 threadNum, UINT64 opNum, UINT64 initNodeNum)
+{
+	Container* pContainer = new Container(initNodeNum);
+	for (UINT64 i = 0; i < initNodeNum; i++)
+		pContainer->Push(i);
+
+	double elapsedSec = RunBenchThreads(threadNum,
+		[](UINT32 threadIdx) {},
+		[&](UINT32 threadIdx)
+		{
+			UINT64 data;
+			for (UINT64 i = 0; i < opNum; i++)
+			{
+				pContainer->Push(((UINT64)threadIdx << 32) | i);
+				pContainer->Pop(&data);
+			}
+		});
+
+	delete pContainer;
+
+	return elapsedSec > 0 ? (double)threadNum * opNum * 2 / elapsedSec / 1000000.0 : 0.0;
+}
+
+int main(int argc, char* argv[])
+{
+	UINT64 opNum = argc > 1 ? strtoull(argv[1], nullptr, 10) : DEFAULT_OP_NUM;
+	UINT64 initNodeNum = argc > 2 ? strtoull(argv[2], nullptr, 10) : DEFAULT_INIT_NODE;
+	if (opNum == 0)
+	{
+		printf("Usage: %s [opNumPerThread] [initNodeNum]\n", argv[0]);
+		return 1;
+	}
+
+	printf("Ops per thread  : %llu (Push + Pop pairs)\n", opNum);
+	printf("Initial nodes   : %llu\n", initNodeNum);
+	printf("Throughput      : Mops/sec\n\n");
+	printf("%8s %14s %14s %14s %14s\n", "Threads", "Stack(LF)", "Stack(mutex)", "Queue(LF)", "Queue(mutex)");
+	for (UINT32 threadNum = 1; threadNum <= MAX_THREAD_NUM; threadNum *= 2)
+	{
+		printf("%8u %14.2f %14.2f %14.2f %14.2f\n", threadNum,
+			Run<StackLockFree>(threadNum, opNum, initNodeNum),
+			Run<DequeMutex<true>>(threadNum, opNum, initNodeNum),
+			Run<QueueLockFree>(threadNum, opNum, initNodeNum),
+			Run<DequeMutex<false>>(threadNum, opNum, initNodeNum));
+	}
+	return 0;
+}
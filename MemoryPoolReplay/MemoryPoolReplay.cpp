@@ -0,0 +1,455 @@
+/*
+# MemoryPoolReplay
+
+AllocTracer(MEMORYPOOL_TRACE)  Ҵ  
+ MemoryPoolTLS  Ǵ malloc  ϰ  մϴ.
+
+MemoryPoolReplay <trace file> malloc
+MemoryPoolReplay <trace file> tls <ChunkSize> <initBlockNum> <maxBlockLimit>
+	ChunkSize: 50, 100, 200, 400, 800, 1600  
+	initBlockNum, maxBlockLimit   Ǯ  
+
+-   帶  带 ϳ ϸ ̺Ʈ  TSC 
+-    ̻ Ҵٸ ִ  ringEventNum ̺Ʈ 
+- Ǯ (Ǯ ID, ̺Ʈ ϵ ü ũ) ϹǷ  Ǯ ID  
+- ϴ Ǯ MEMORYPOOL_TRACE  Ͽ    Ե 
+  Chunk FreeStack CAS Ƚ MEMORYPOOL_COUNT_CASθ 
+- ٸ 忡 Ҵ  ȯ ش Ҵ   
+   尡 ھ  Ƶ Ҵ 尡 ǵ    纸
+-  ũ 2 ŵ Ŷ(16 ~ 8192byte) ø
+- ִ RSS μ ̹Ƿ   ࿡ ϳ  
+    Working Set    ֱ  ִ밪 ̸ Ҵ  
+- ĳ ̽ ġ ó ϴ ĳöΰ
+   ٸ 尡 ߴ  ĳö   
+*/
+#define MEMORYPOOL_MODE_RELEASE
+#define MEMORYPOOL_COUNT_CAS
+#include "../MemoryPoolTLS/MemoryPoolTLS.h"
+#include "../MemoryPoolTLS/AllocTraceFormat.h"
+#include "../BenchHarness/BenchHarness.h"
+#include <psapi.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+#define CACHE_LINE_SIZE		64
+#define MIN_BUCKET_SIZE		16
+#define MAX_BUCKET_SIZE		8192
+#define ALLOC_FAILED		((void*)1)
+#define RSS_SAMPLE_PERIOD	1	// ms
+#define WAIT_SPIN_COUNT		64
+
+struct REPLAY_OP
+{
+	UINT64	_seq;		// ü ̺Ʈ 
+	UINT32	_slot;		//  ĺ ȣ
+	UINT16	_poolIdx;
+	bool	_isAlloc;
+};
+
+struct REPLAY_POOL
+{
+	UINT32	_objectSize;
+	UINT32	_bucketSize;
+};
+
+struct TOUCH
+{
+	UINT64	_seq;
+	UINT64	_addr;
+	UINT32	_lineCnt;
+	UINT32	_threadIdx;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+/* Allocator */
+class ReplayAllocator
+{
+public:
+	virtual ~ReplayAllocator() {}
+	virtual void* Alloc(UINT16 poolIdx) = 0;
+	virtual void Free(UINT16 poolIdx, void* ptr) = 0;
+	virtual UINT64 GetCasCount() { return 0; }
+	virtual UINT64 GetCasFailCount() { return 0; }
+};
+
+class MallocAllocator : public ReplayAllocator
+{
+public:
+	MallocAllocator(const std::vector<REPLAY_POOL>& pools) :_pools(pools) {}
+	void* Alloc(UINT16 poolIdx) override { return malloc(_pools[poolIdx]._bucketSize); }
+	void Free(UINT16 poolIdx, void* ptr) override { free(ptr); }
+private:
+	std::vector<REPLAY_POOL> _pools;
+};
+
+template <size_t Size>
+struct PAYLOAD
+{
+	BYTE	_data[Size];
+};
+
+class ReplayPoolBase
+{
+public:
+	virtual ~ReplayPoolBase() {}
+	virtual void* Alloc() = 0;
+	virtual void Free(void* ptr) = 0;
+	virtual UINT64 GetCasCount() = 0;
+	virtual UINT64 GetCasFailCount() = 0;
+};
+
+template <size_t ChunkSize, size_t Size>
+class ReplayPool : public ReplayPoolBase
+{
+public:
+	ReplayPool(UINT64 initBlockNum, UINT64 maxBlockLimit) :_pool(initBlockNum, maxBlockLimit, false) {}
+	void* Alloc() override { return _pool.Alloc(); }
+	void Free(void* ptr) override { _pool.Free(reinterpret_cast<PAYLOAD<Size>*>(ptr)); }
+	UINT64 GetCasCount() override { return _pool.GetChunkStackCasCount(); }
+	UINT64 GetCasFailCount() override { return _pool.GetChunkStackCasFailCount(); }
+private:
+	MemoryPoolTLS<PAYLOAD<Size>, ChunkSize> _pool;
+};
+
+template <size_t ChunkSize>
+class TlsAllocator : public ReplayAllocator
+{
+public:
+	TlsAllocator(const std::vector<REPLAY_POOL>& pools, UINT64 initBlockNum, UINT64 maxBlockLimit)
+	{
+		for (const REPLAY_POOL& pool : pools)
+			_pools.push_back(CreatePool(pool._bucketSize, initBlockNum, maxBlockLimit));
+	}
+	~TlsAllocator()
+	{
+		for (ReplayPoolBase* pPool : _pools)
+			delete pPool;
+	}
+	void* Alloc(UINT16 poolIdx) override { return _pools[poolIdx]->Alloc(); }
+	void Free(UINT16 poolIdx, void* ptr) override { _pools[poolIdx]->Free(ptr); }
+	UINT64 GetCasCount() override
+	{
+		UINT64 cnt = 0;
+		for (ReplayPoolBase* pPool : _pools)
+			cnt += pPool->GetCasCount();
+		return cnt;
+	}
+	UINT64 GetCasFailCount() override
+	{
+		UINT64 cnt = 0;
+		for (ReplayPoolBase* pPool : _pools)
+			cnt += pPool->GetCasFailCount();
+		return cnt;
+	}
+private:
+	static ReplayPoolBase* CreatePool(UINT32 bucketSize, UINT64 initBlockNum, UINT64 maxBlockLimit)
+	{
+		switch (bucketSize)
+		{
+		case 16:	return new ReplayPool<ChunkSize, 16>(initBlockNum, maxBlockLimit);
+		case 32:	return new ReplayPool<ChunkSize, 32>(initBlockNum, maxBlockLimit);
+		case 64:	return new ReplayPool<ChunkSize, 64>(initBlockNum, maxBlockLimit);
+		case 128:	return new ReplayPool<ChunkSize, 128>(initBlockNum, maxBlockLimit);
+		case 256:	return new ReplayPool<ChunkSize, 256>(initBlockNum, maxBlockLimit);
+		case 512:	return new ReplayPool<ChunkSize, 512>(initBlockNum, maxBlockLimit);
+		case 1024:	return new ReplayPool<ChunkSize, 1024>(initBlockNum, maxBlockLimit);
+		case 2048:	return new ReplayPool<ChunkSize, 2048>(initBlockNum, maxBlockLimit);
+		case 4096:	return new ReplayPool<ChunkSize, 4096>(initBlockNum, maxBlockLimit);
+		default:	return new ReplayPool<ChunkSize, MAX_BUCKET_SIZE>(initBlockNum, maxBlockLimit);
+		}
+	}
+private:
+	std::vector<ReplayPoolBase*> _pools;
+};
+
+static ReplayAllocator* CreateTlsAllocator(size_t chunkSize, const std::vector<REPLAY_POOL>& pools, UINT64 initBlockNum, UINT64 maxBlockLimit)
+{
+	switch (chunkSize)
+	{
+	case 50:	return new TlsAllocator<50>(pools, initBlockNum, maxBlockLimit);
+	case 100:	return new TlsAllocator<100>(pools, initBlockNum, maxBlockLimit);
+	case 200:	return new TlsAllocator<200>(pools, initBlockNum, maxBlockLimit);
+	case 400:	return new TlsAllocator<400>(pools, initBlockNum, maxBlockLimit);
+	case 800:	return new TlsAllocator<800>(pools, initBlockNum, maxBlockLimit);
+	case 1600:	return new TlsAllocator<1600>(pools, initBlockNum, maxBlockLimit);
+	default:	return nullptr;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+/* Trace */
+static bool LoadTrace(const char* fileName, std::vector<TRACE_EVENT>* pEvents)
+{
+	FILE* file = fopen(fileName, "rb");
+	if (file == nullptr)
+		return false;
+
+	TRACE_FILE_HEADER header;
+	if (fread(&header, sizeof(header), 1, file) != 1 || header._magic != TRACE_FILE_MAGIC
+		|| header._version != TRACE_FILE_VERSION || header._eventSize != sizeof(TRACE_EVENT))
+	{
+		fclose(file);
+		return false;
+	}
+
+	//  Ѿ ߴٸ  ġ ȿ
+	UINT64 eventNum = header._totalEventNum < header._ringEventNum ? header._totalEventNum : header._ringEventNum;
+	pEvents->resize(eventNum);
+	eventNum = fread(pEvents->data(), sizeof(TRACE_EVENT), eventNum, file);
+	pEvents->resize(eventNum);
+	fclose(file);
+
+	// 庰    ϵǹǷ TSC  
+	std::stable_sort(pEvents->begin(), pEvents->end(),
+		[](const TRACE_EVENT& a, const TRACE_EVENT& b) { return a._tsc < b._tsc; });
+	return true;
+}
+
+static UINT32 GetBucketSize(UINT32 objectSize)
+{
+	UINT32 bucketSize = MIN_BUCKET_SIZE;
+	while (bucketSize < objectSize && bucketSize < MAX_BUCKET_SIZE)
+		bucketSize <<= 1;
+	return bucketSize;
+}
+
+//  ̺Ʈ  庰   ȯ
+static UINT32 BuildReplay(const std::vector<TRACE_EVENT>& events, std::vector<REPLAY_POOL>* pPools,
+	std::vector<std::vector<REPLAY_OP>>* pThreadOps)
+{
+	std::unordered_map<UINT64, UINT16> poolIdxMap;	// (poolId << 16) | ü ũ ->  Ǯ ȣ
+	std::unordered_map<UINT32, UINT32> threadIdxMap;
+	std::unordered_map<UINT64, UINT32> liveSlotMap;	// (poolId << 48) |  ּ -> slot
+	UINT32 slotCnt = 0;
+	UINT64 seq = 0;
+
+	for (const TRACE_EVENT& ev : events)
+	{
+		// Ǯ   ̺Ʈ Բ ϵǾ 
+		if (ev._op == TRACE_OP_POOL_CREATE || ev._op == TRACE_OP_POOL_DESTROY)
+			continue;
+
+		UINT32 objectSize = (UINT32)(ev._objectId >> 48);
+		auto poolIter = poolIdxMap.find(((UINT64)ev._poolId << 16) | objectSize);
+		if (poolIter == poolIdxMap.end())
+		{
+			REPLAY_POOL pool;
+			pool._objectSize = objectSize;
+			pool._bucketSize = GetBucketSize(pool._objectSize);
+			poolIter = poolIdxMap.emplace(((UINT64)ev._poolId << 16) | objectSize, (UINT16)pPools->size()).first;
+			pPools->push_back(pool);
+		}
+
+		auto threadIter = threadIdxMap.find(ev._threadId);
+		if (threadIter == threadIdxMap.end())
+		{
+			threadIter = threadIdxMap.emplace(ev._threadId, (UINT32)pThreadOps->size()).first;
+			pThreadOps->emplace_back();
+		}
+
+		REPLAY_OP op;
+		op._seq = seq++;
+		op._poolIdx = poolIter->second;
+		UINT64 key = ((UINT64)ev._poolId << 48) | (ev._objectId & 0xFFFFFFFFFFFF);
+		if (ev._op == TRACE_OP_ALLOC)
+		{
+			op._isAlloc = true;
+			op._slot = slotCnt++;
+			liveSlotMap[key] = op._slot;
+		}
+		else
+		{
+			//    Ҵ  ȯ 
+			auto slotIter = liveSlotMap.find(key);
+			if (slotIter == liveSlotMap.end())
+				continue;
+			op._isAlloc = false;
+			op._slot = slotIter->second;
+			liveSlotMap.erase(slotIter);
+		}
+		(*pThreadOps)[threadIter->second].push_back(op);
+	}
+	return slotCnt;
+}
+
+//   ٸ 尡 ߰ų ó ϴ 츦 ĳ ̽ 
+static UINT64 EstimateCacheMiss(std::vector<TOUCH>& touches)
+{
+	std::sort(touches.begin(), touches.end(),
+		[](const TOUCH& a, const TOUCH& b) { return a._seq < b._seq; });
+
+	std::unordered_map<UINT64, UINT32> lastThreadMap;
+	UINT64 missCnt = 0;
+	for (const TOUCH& touch : touches)
+	{
+		auto iter = lastThreadMap.find(touch._addr);
+		if (iter == lastThreadMap.end())
+		{
+			missCnt += touch._lineCnt;
+			lastThreadMap.emplace(touch._addr, touch._threadIdx);
+		}
+		else if (iter->second != touch._threadIdx)
+		{
+			missCnt += touch._lineCnt;
+			iter->second = touch._threadIdx;
+		}
+	}
+	return missCnt;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+	if (argc < 3 || (strcmp(argv[2], "tls") == 0 && argc < 6))
+	{
+		printf("Usage: %s <trace file> malloc\n", argv[0]);
+		printf("       %s <trace file> tls <ChunkSize> <initBlockNum> <maxBlockLimit>\n", argv[0]);
+		return 1;
+	}
+
+	std::vector<TRACE_EVENT> events;
+	if (!LoadTrace(argv[1], &events))
+	{
+		printf("Error: Failed to load trace file.\n");
+		return 1;
+	}
+
+	std::vector<REPLAY_POOL> pools;
+	std::vector<std::vector<REPLAY_OP>> threadOps;
+	UINT32 slotCnt = BuildReplay(events, &pools, &threadOps);
+
+	// ࿡ ʿ   ̺Ʈ   
+	std::vector<TRACE_EVENT>().swap(events);
+
+	ReplayAllocator* pAllocator;
+	if (strcmp(argv[2], "malloc") == 0)
+	{
+		pAllocator = new MallocAllocator(pools);
+	}
+	else
+	{
+		pAllocator = CreateTlsAllocator(strtoull(argv[3], nullptr, 10), pools,
+			strtoull(argv[4], nullptr, 10), strtoull(argv[5], nullptr, 10));
+		if (pAllocator == nullptr)
+		{
+			printf("Error: Unsupported ChunkSize.\n");
+			return 1;
+		}
+	}
+
+	void* volatile* slots = new void* volatile[slotCnt]();
+	//    Working Set ø ʵ ̸ ä
+	std::vector<std::vector<TOUCH>> threadTouches(threadOps.size());
+	for (size_t i = 0; i < threadOps.size(); i++)
+		threadTouches[i].resize(threadOps[i].size());
+
+	volatile LONG64 failCnt = 0;
+	PROCESS_MEMORY_COUNTERS pmc;
+	pmc.cb = sizeof(pmc);
+	SIZE_T baseRss = 0;
+	SIZE_T peakRss = 0;
+	double elapsedSec = RunBenchThreads((UINT32)threadOps.size(),
+		[](UINT32 threadIdx) {},
+		[&](UINT32 threadIdx)
+		{
+			const std::vector<REPLAY_OP>& ops = threadOps[threadIdx];
+			std::vector<TOUCH>& touches = threadTouches[threadIdx];
+
+			void* ptr;
+			size_t touchCnt = 0;
+			for (const REPLAY_OP& op : ops)
+			{
+				if (op._isAlloc)
+				{
+					ptr = pAllocator->Alloc(op._poolIdx);
+					if (ptr == nullptr)
+					{
+						InterlockedIncrement64((PLONG64)&failCnt);
+						slots[op._slot] = ALLOC_FAILED;
+						continue;
+					}
+					slots[op._slot] = ptr;
+				}
+				else
+				{
+					// ٸ  Ҵ   
+					for (UINT32 spinCnt = 0; (ptr = slots[op._slot]) == nullptr; spinCnt++)
+					{
+						if (spinCnt < WAIT_SPIN_COUNT)
+							YieldProcessor();
+						else
+							SwitchToThread();
+					}
+					slots[op._slot] = nullptr;
+					if (ptr == ALLOC_FAILED)
+						continue;
+					pAllocator->Free(op._poolIdx, ptr);
+				}
+				touches[touchCnt++] = { op._seq, (UINT64)ptr,
+					(pools[op._poolIdx]._objectSize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE, threadIdx };
+			}
+			touches.resize(touchCnt);
+		},
+		[&]()
+		{
+			//   尡 غǸ  Working Set 
+			GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
+			baseRss = pmc.WorkingSetSize;
+			peakRss = baseRss;
+		},
+		[&]()
+		{
+			// μ ִ밪   ε  ԵǹǷ  ߿  
+			GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
+			if (pmc.WorkingSetSize > peakRss)
+				peakRss = pmc.WorkingSetSize;
+			Sleep(RSS_SAMPLE_PERIOD);
+		});
+
+	GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
+	if (pmc.WorkingSetSize > peakRss)
+		peakRss = pmc.WorkingSetSize;
+
+	UINT64 opCnt = 0;
+	for (const std::vector<REPLAY_OP>& ops : threadOps)
+		opCnt += ops.size();
+
+	std::vector<TOUCH> touches;
+	touches.reserve(opCnt);
+	for (const std::vector<TOUCH>& threadTouch : threadTouches)
+		touches.insert(touches.end(), threadTouch.begin(), threadTouch.end());
+
+	printf("Target          : %s", argv[2]);
+	if (strcmp(argv[2], "tls") == 0)
+		printf(" ChunkSize=%s initBlockNum=%s maxBlockLimit=%s", argv[3], argv[4], argv[5]);
+	printf("\n");
+	printf("Pools / Threads : %zu / %zu\n", pools.size(), threadOps.size());
+	printf("Operations      : %llu\n", opCnt);
+	printf("Alloc failures  : %lld\n", failCnt);
+	printf("Elapsed         : %.3f sec\n", elapsedSec);
+	printf("Throughput      : %.2f Mops/sec\n", elapsedSec > 0 ? opCnt / elapsedSec / 1000000.0 : 0.0);
+	printf("Peak RSS        : %.2f MB (allocator %.2f MB)\n", peakRss / (1024.0 * 1024.0), (peakRss - baseRss) / (1024.0 * 1024.0));
+	printf("Chunk stack CAS : %llu (failed %llu)\n", pAllocator->GetCasCount(), pAllocator->GetCasFailCount());
+	printf("Est. cache miss : %llu lines\n", EstimateCacheMiss(touches));
+
+	// ȯ   
+	for (UINT32 threadIdx = 0; threadIdx < (UINT32)threadOps.size(); threadIdx++)
+	{
+		for (const REPLAY_OP& op : threadOps[threadIdx])
+		{
+			void* ptr = slots[op._slot];
+			if (op._isAlloc && ptr != nullptr && ptr != ALLOC_FAILED)
+			{
+				pAllocator->Free(op._poolIdx, ptr);
+				slots[op._slot] = nullptr;
+			}
+		}
+	}
+	delete[] slots;
+	delete pAllocator;
+	return 0;
+}
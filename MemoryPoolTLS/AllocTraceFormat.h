@@ -0,0 +1,51 @@
+#pragma once
+#include <Windows.h>
+
+/*
+# Ҵ   
+
+AllocTracer ϰ MemoryPoolReplay д  Դϴ.
+      մϴ.
+
+ [TRACE_FILE_HEADER][TRACE_EVENT * ringEventNum] ũ ̸
+  ó ư   ̺Ʈ ϴ.
+ _totalEventNum ۸   ŵǹǷ   ÿ   ְ
+_totalEventNum % ringEventNum ġ  ϵ( ) ̺ƮԴϴ.
+*/
+
+#define TRACE_FILE_MAGIC		0x31454341525450ULL	// "PTRACE1"
+#define TRACE_FILE_VERSION		2
+#define TRACE_MAX_OBJECT_SIZE	0xFFFF
+
+enum TRACE_OP : UINT8
+{
+	TRACE_OP_POOL_CREATE = 0,	// _objectId = (ChunkSize << 32) | sizeof(T)
+	TRACE_OP_POOL_DESTROY,
+	TRACE_OP_ALLOC,				// _objectId = (min(sizeof(T), TRACE_MAX_OBJECT_SIZE) << 48) |  ּ
+	TRACE_OP_FREE,
+	TRACE_OP_RETIRE
+};
+
+#pragma pack(push, 1)
+struct TRACE_FILE_HEADER
+{
+	UINT64	_magic;
+	UINT32	_version;
+	UINT32	_eventSize;
+	UINT64	_qpcFrequency;
+	UINT64	_qpcStart;
+	UINT64	_tscStart;
+	UINT64	_ringEventNum;
+	UINT64	_totalEventNum;		// ݱ  ̺Ʈ 
+};
+
+struct TRACE_EVENT
+{
+	UINT64	_tsc;
+	UINT64	_objectId;
+	UINT32	_threadId;
+	UINT16	_poolId;
+	UINT8	_op;
+	UINT8	_reserved;
+};
+#pragma pack(pop)
@@ -0,0 +1,300 @@
+#pragma once
+#include <Windows.h>
+#include <intrin.h>
+#include "AllocTraceFormat.h"
+
+/*
+# Ҵ (AllocTracer)
+
+MEMORYPOOL_TRACE defineϸ MemoryPoolTLS Alloc/Free/RetireEpoch
+庰 ۿ ̺Ʈ ϰ, ۰   Ͽ ϰ մϴ.
+ϵ  MemoryPoolReplay ٸ Ǯ ̳ malloc    ֽϴ.
+
+AllocTracer::GetInstance()->Start(L"trace.bin", ringEventNum);
+...
+AllocTracer::GetInstance()->Stop();	//      ȣ
+
+  AllocTraceFormat.h ϼ.
+
+Start   Ǯ  Start  Ͽ ϵǸ
+Stop    ۴    ϵ˴ϴ.
+POOL_CREATE ̴   ֵ  ̺Ʈ ü ũ⸦ Բ մϴ.
+*/
+
+#define TRACE_EVENT_IN_BUFFER	4096
+#define TRACE_MAX_POOL			4096
+#define TRACE_DEFAULT_RING_EVENT	(1 << 22)	// 96MB
+
+class AllocTracer
+{
+private:
+	struct BUFFER
+	{
+		TRACE_EVENT	_events[TRACE_EVENT_IN_BUFFER];
+		UINT32		_count;
+		DWORD		_threadId;
+		BUFFER*		_next;
+	};
+	struct POOL_INFO
+	{
+		UINT64	_objectId;
+		UINT64	_sizeTag;	//  ̺Ʈ  16bit  ü ũ
+		LONG	_nextFree;
+		bool	_isAlive;
+	};
+public:
+	static AllocTracer* GetInstance()
+	{
+		static AllocTracer instance;
+		return &instance;
+	}
+	bool Start(const WCHAR* fileName, UINT64 ringEventNum = TRACE_DEFAULT_RING_EVENT);
+	void Stop();
+	bool IsRunning() { return _file != INVALID_HANDLE_VALUE; }
+	UINT16 RegisterPool(UINT32 objectSize, UINT32 chunkSize);
+	void UnregisterPool(UINT16 poolId);
+	void Record(TRACE_OP op, UINT16 poolId, UINT64 objectId)
+	{
+		if (_file != INVALID_HANDLE_VALUE)
+			Write(op, poolId, objectId);
+	}
+private:
+	AllocTracer();
+	~AllocTracer();
+	void Write(TRACE_OP op, UINT16 poolId, UINT64 objectId);
+	BUFFER* GetBuffer();
+	void Flush(BUFFER* pBuffer);
+	void WriteRing(const TRACE_EVENT* pEvents, UINT64 eventNum);	// _lock  ¿ ȣ
+	static void WINAPI ReleaseBuffer(PVOID pBuffer);
+private:
+	HANDLE				_file;
+	UINT64				_ringEventNum;
+	UINT64				_totalEventNum;
+	SRWLOCK				_lock;		//  ,  , Ǯ  ȣ
+	DWORD				_flsIdx;
+	BUFFER*				_bufferHead;
+	POOL_INFO			_pools[TRACE_MAX_POOL];
+	LONG				_poolCnt;
+	LONG				_poolFreeHead;	// Ҹ Ǯ ID ,  RegisterPool 
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+inline AllocTracer::AllocTracer() :_file(INVALID_HANDLE_VALUE), _ringEventNum(0), _totalEventNum(0), _bufferHead(nullptr), _pools(), _poolCnt(0), _poolFreeHead(-1)
+{
+	InitializeSRWLock(&_lock);
+	//     ̺Ʈ ϱ  FLS ݹ 
+	_flsIdx = FlsAlloc(ReleaseBuffer);
+	if (_flsIdx == FLS_OUT_OF_INDEXES)
+		throw GetLastError();
+}
+
+inline AllocTracer::~AllocTracer()
+{
+	Stop();
+	FlsFree(_flsIdx);
+}
+
+inline bool AllocTracer::Start(const WCHAR* fileName, UINT64 ringEventNum)
+{
+	//  ϳ     ʵ 
+	if (ringEventNum < TRACE_EVENT_IN_BUFFER)
+		return false;
+
+	AcquireSRWLockExclusive(&_lock);
+	if (_file != INVALID_HANDLE_VALUE)
+	{
+		ReleaseSRWLockExclusive(&_lock);
+		return false;
+	}
+
+	HANDLE file = CreateFileW(fileName, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		ReleaseSRWLockExclusive(&_lock);
+		return false;
+	}
+
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	TRACE_FILE_HEADER header;
+	header._magic = TRACE_FILE_MAGIC;
+	header._version = TRACE_FILE_VERSION;
+	header._eventSize = sizeof(TRACE_EVENT);
+	header._qpcFrequency = frequency.QuadPart;
+	header._qpcStart = counter.QuadPart;
+	header._tscStart = __rdtsc();
+	header._ringEventNum = ringEventNum;
+	header._totalEventNum = 0;
+
+	DWORD written;
+	WriteFile(file, &header, sizeof(header), &written, NULL);
+
+	_file = file;
+	_ringEventNum = ringEventNum;
+	_totalEventNum = 0;
+
+	// ̹ Ǿ ִ Ǯ  
+	TRACE_EVENT ev;
+	ev._tsc = header._tscStart;
+	ev._threadId = GetCurrentThreadId();
+	ev._op = TRACE_OP_POOL_CREATE;
+	ev._reserved = 0;
+	for (LONG i = 0; i < _poolCnt; i++)
+	{
+		if (!_pools[i]._isAlive)
+			continue;
+		ev._objectId = _pools[i]._objectId;
+		ev._poolId = (UINT16)i;
+		WriteRing(&ev, 1);
+	}
+	ReleaseSRWLockExclusive(&_lock);
+	return true;
+}
+
+inline void AllocTracer::Stop()
+{
+	AcquireSRWLockExclusive(&_lock);
+	if (_file == INVALID_HANDLE_VALUE)
+	{
+		ReleaseSRWLockExclusive(&_lock);
+		return;
+	}
+
+	for (BUFFER* pBuffer = _bufferHead; pBuffer != nullptr; pBuffer = pBuffer->_next)
+	{
+		WriteRing(pBuffer->_events, pBuffer->_count);
+		pBuffer->_count = 0;
+	}
+	CloseHandle(_file);
+	_file = INVALID_HANDLE_VALUE;
+	ReleaseSRWLockExclusive(&_lock);
+}
+
+inline UINT16 AllocTracer::RegisterPool(UINT32 objectSize, UINT32 chunkSize)
+{
+	LONG poolId;
+	AcquireSRWLockExclusive(&_lock);
+	if (_poolFreeHead != -1)
+	{
+		// Ҹ Ǯ ID 
+		poolId = _poolFreeHead;
+		_poolFreeHead = _pools[poolId]._nextFree;
+	}
+	else if (_poolCnt < TRACE_MAX_POOL)
+	{
+		poolId = _poolCnt++;
+	}
+	else
+	{
+		ReleaseSRWLockExclusive(&_lock);
+		throw L"Error: Too many traced pools.";
+	}
+
+	_pools[poolId]._objectId = ((UINT64)chunkSize << 32) | objectSize;
+	_pools[poolId]._sizeTag = (UINT64)(objectSize < TRACE_MAX_OBJECT_SIZE ? objectSize : TRACE_MAX_OBJECT_SIZE) << 48;
+	_pools[poolId]._nextFree = -1;
+	_pools[poolId]._isAlive = true;
+	ReleaseSRWLockExclusive(&_lock);
+
+	// ۸ ó Ҵ  _lock Ƿ   
+	Record(TRACE_OP_POOL_CREATE, (UINT16)poolId, _pools[poolId]._objectId);
+	return (UINT16)poolId;
+}
+
+inline void AllocTracer::UnregisterPool(UINT16 poolId)
+{
+	Record(TRACE_OP_POOL_DESTROY, poolId, 0);
+
+	AcquireSRWLockExclusive(&_lock);
+	_pools[poolId]._isAlive = false;
+	_pools[poolId]._nextFree = _poolFreeHead;
+	_poolFreeHead = poolId;
+	ReleaseSRWLockExclusive(&_lock);
+}
+
+inline void AllocTracer::Write(TRACE_OP op, UINT16 poolId, UINT64 objectId)
+{
+	BUFFER* pBuffer = GetBuffer();
+	TRACE_EVENT& ev = pBuffer->_events[pBuffer->_count];
+	ev._tsc = __rdtsc();
+	ev._objectId = op >= TRACE_OP_ALLOC ? objectId | _pools[poolId]._sizeTag : objectId;
+	ev._threadId = pBuffer->_threadId;
+	ev._poolId = poolId;
+	ev._op = op;
+	ev._reserved = 0;
+
+	if (++pBuffer->_count == TRACE_EVENT_IN_BUFFER)
+		Flush(pBuffer);
+}
+
+inline AllocTracer::BUFFER* AllocTracer::GetBuffer()
+{
+	BUFFER* pBuffer = reinterpret_cast<BUFFER*>(FlsGetValue(_flsIdx));
+	if (pBuffer != nullptr)
+		return pBuffer;
+
+	pBuffer = new BUFFER;
+	pBuffer->_count = 0;
+	pBuffer->_threadId = GetCurrentThreadId();
+
+	AcquireSRWLockExclusive(&_lock);
+	pBuffer->_next = _bufferHead;
+	_bufferHead = pBuffer;
+	ReleaseSRWLockExclusive(&_lock);
+
+	FlsSetValue(_flsIdx, pBuffer);
+	return pBuffer;
+}
+
+inline void AllocTracer::Flush(BUFFER* pBuffer)
+{
+	AcquireSRWLockExclusive(&_lock);
+	if (_file != INVALID_HANDLE_VALUE)
+		WriteRing(pBuffer->_events, pBuffer->_count);
+	pBuffer->_count = 0;
+	ReleaseSRWLockExclusive(&_lock);
+}
+
+inline void AllocTracer::WriteRing(const TRACE_EVENT* pEvents, UINT64 eventNum)
+{
+	DWORD written;
+	LARGE_INTEGER pos;
+	UINT64 ringIdx;
+	UINT64 writeNum;
+	while (eventNum > 0)
+	{
+		//   Ѵ κ ó ̾ 
+		ringIdx = _totalEventNum % _ringEventNum;
+		writeNum = _ringEventNum - ringIdx < eventNum ? _ringEventNum - ringIdx : eventNum;
+		pos.QuadPart = sizeof(TRACE_FILE_HEADER) + ringIdx * sizeof(TRACE_EVENT);
+		SetFilePointerEx(_file, pos, NULL, FILE_BEGIN);
+		WriteFile(_file, pEvents, (DWORD)(sizeof(TRACE_EVENT) * writeNum), &written, NULL);
+
+		pEvents += writeNum;
+		eventNum -= writeNum;
+		_totalEventNum += writeNum;
+	}
+
+	pos.QuadPart = FIELD_OFFSET(TRACE_FILE_HEADER, _totalEventNum);
+	SetFilePointerEx(_file, pos, NULL, FILE_BEGIN);
+	WriteFile(_file, &_totalEventNum, sizeof(_totalEventNum), &written, NULL);
+}
+
+inline void WINAPI AllocTracer::ReleaseBuffer(PVOID pBuffer)
+{
+	AllocTracer* pTracer = GetInstance();
+	BUFFER* pMyBuffer = reinterpret_cast<BUFFER*>(pBuffer);
+	pTracer->Flush(pMyBuffer);
+
+	AcquireSRWLockExclusive(&pTracer->_lock);
+	BUFFER** ppBuffer = &pTracer->_bufferHead;
+	while (*ppBuffer != pMyBuffer)
+		ppBuffer = &(*ppBuffer)->_next;
+	*ppBuffer = pMyBuffer->_next;
+	ReleaseSRWLockExclusive(&pTracer->_lock);
+
+	delete pMyBuffer;
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include "MemoryPoolTLS.h"
+#include <new>
+#define COROUTINE_FRAME_MIN_SIZE	128
+#define COROUTINE_FRAME_MAX_SIZE	4096
+#define COROUTINE_FRAME_CHUNK_BYTES	(64 * 1024)	// Ŷ Chunk ϳ ǥ ũ
+#define COROUTINE_FRAME_MIN_CHUNK	16
+
+/*
+# ڷƾ  Ǯ(C++20)
+
+promise_type PooledPromise ϸ ڷƾ   
+ũ⺰ Ŷ(COROUTINE_FRAME_MIN_SIZE 2辿 COROUTINE_FRAME_MAX_SIZE) MemoryPoolTLS Ҵ˴ϴ.
+
+struct Task
+{
+	struct promise_type : PooledPromise
+	{
+		...
+	};
+};
+
+-  ȯ ũⰡ Բ ޵Ǵ operator delete Ŷ ã
+- ٸ 忡 resumeǾ     TLS Chunk ȯ
+- COROUTINE_FRAME_MAX_SIZE ū  ⺻ operator new 
+- ū Ŷϼ ChunkSize ٿ Chunk ϳ COROUTINE_FRAME_CHUNK_BYTES  ǵ 
+  (128byte NUM_OF_BLOCK_IN_CHUNK, 4096byte COROUTINE_FRAME_MIN_CHUNK)
+*/
+
+template <size_t Size>
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) COROUTINE_FRAME
+{
+	BYTE	_data[Size];
+};
+
+constexpr size_t CoroutineFrameChunkSize(size_t size)
+{
+	return COROUTINE_FRAME_CHUNK_BYTES / size > NUM_OF_BLOCK_IN_CHUNK ? NUM_OF_BLOCK_IN_CHUNK
+		: COROUTINE_FRAME_CHUNK_BYTES / size < COROUTINE_FRAME_MIN_CHUNK ? COROUTINE_FRAME_MIN_CHUNK
+		: COROUTINE_FRAME_CHUNK_BYTES / size;
+}
+
+class CoroutineFramePool
+{
+public:
+	static void* Alloc(size_t size);
+	static void Free(void* pFrame, size_t size);
+private:
+	template <size_t Size>
+	using FramePool = MemoryPoolTLS<COROUTINE_FRAME<Size>, CoroutineFrameChunkSize(Size)>;
+
+	template <size_t Size>
+	static FramePool<Size>* GetPool()
+	{
+		// μ     ȯ  Ƿ ҸŰ 
+		static FramePool<Size>* pPool = new FramePool<Size>(0, POOL_MAX_ALLOC, false);
+		return pPool;
+	}
+	// size    Ŷ 
+	template <size_t Size>
+	static void* AllocBucket(size_t size)
+	{
+		if constexpr (Size >= COROUTINE_FRAME_MAX_SIZE)
+			return AllocFrame<COROUTINE_FRAME_MAX_SIZE>();
+		else
+			return size <= Size ? AllocFrame<Size>() : AllocBucket<Size * 2>(size);
+	}
+	template <size_t Size>
+	static void FreeBucket(void* pFrame, size_t size)
+	{
+		if constexpr (Size >= COROUTINE_FRAME_MAX_SIZE)
+			FreeFrame<COROUTINE_FRAME_MAX_SIZE>(pFrame);
+		else if (size <= Size)
+			FreeFrame<Size>(pFrame);
+		else
+			FreeBucket<Size * 2>(pFrame, size);
+	}
+	template <size_t Size>
+	static void* AllocFrame()
+	{
+		void* pFrame = GetPool<Size>()->Alloc();
+		if (pFrame == nullptr)
+			throw std::bad_alloc();
+		return pFrame;
+	}
+	template <size_t Size>
+	static void FreeFrame(void* pFrame)
+	{
+		GetPool<Size>()->Free(reinterpret_cast<COROUTINE_FRAME<Size>*>(pFrame));
+	}
+};
+
+// promise_type Ͽ 
+struct PooledPromise
+{
+	static void* operator new(size_t size) { return CoroutineFramePool::Alloc(size); }
+	static void operator delete(void* pFrame, size_t size) { CoroutineFramePool::Free(pFrame, size); }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+inline void* CoroutineFramePool::Alloc(size_t size)
+{
+	if (size <= COROUTINE_FRAME_MAX_SIZE)
+		return AllocBucket<COROUTINE_FRAME_MIN_SIZE>(size);
+	return ::operator new(size);
+}
+
+inline void CoroutineFramePool::Free(void* pFrame, size_t size)
+{
+	if (size <= COROUTINE_FRAME_MAX_SIZE)
+		return FreeBucket<COROUTINE_FRAME_MIN_SIZE>(pFrame, size);
+	::operator delete(pFrame);
+}
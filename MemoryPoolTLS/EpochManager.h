@@ -0,0 +1,149 @@
+#pragma once
+#include <Windows.h>
+
+/*
+# Epoch  ޸ ȸ(EBR)
+
+LockFree ڷᱸ 带 д  EpochGuard ΰ
+ ȯ Free  MemoryPoolTLS::RetireEpoch ϸ
+а ִ 尡   ڿ  Ǯ ưϴ.
+
+ Epoch  ִ  尡  Epoch   1 ϹǷ
+Epoch e ȸ    Epoch e + 2 ̻ Ǹ ϰ ȯ  ֽϴ.
+*/
+
+class EpochManager
+{
+private:
+	// 庰 Epoch , ѹ    ʰ    
+	struct RECORD
+	{
+		volatile UINT64	_state;		// ( Epoch << 1) |  
+		volatile LONG	_inUse;
+		UINT64			_nest;
+		RECORD*			_next;
+	};
+public:
+	static EpochManager* GetInstance()
+	{
+		static EpochManager instance;
+		return &instance;
+	}
+	void Enter();
+	void Leave();
+	bool TryAdvance();
+	UINT64 GetEpoch() { return _globalEpoch; }
+	bool IsSafe(UINT64 retireEpoch) { return retireEpoch + 2 <= _globalEpoch; }
+private:
+	EpochManager();
+	~EpochManager();
+	RECORD* GetRecord();
+	static void WINAPI ReleaseRecord(PVOID pRecord);
+private:
+	volatile UINT64		_globalEpoch;
+	RECORD* volatile	_recordHead;
+	DWORD				_flsIdx;
+};
+
+//  Ҹ  带 Epoch Ӱ豸 ԽŴ(ø )
+class EpochGuard
+{
+public:
+	EpochGuard() { EpochManager::GetInstance()->Enter(); }
+	~EpochGuard() { EpochManager::GetInstance()->Leave(); }
+	EpochGuard(const EpochGuard&) = delete;
+	EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+inline EpochManager::EpochManager() :_globalEpoch(0), _recordHead(nullptr)
+{
+	//     ݳޱ  FLS ݹ 
+	_flsIdx = FlsAlloc(ReleaseRecord);
+	if (_flsIdx == FLS_OUT_OF_INDEXES)
+		throw GetLastError();
+}
+
+inline EpochManager::~EpochManager()
+{
+	FlsFree(_flsIdx);
+
+	RECORD* pRecord = _recordHead;
+	RECORD* pNext;
+	while (pRecord != nullptr)
+	{
+		pNext = pRecord->_next;
+		delete pRecord;
+		pRecord = pNext;
+	}
+}
+
+inline void EpochManager::Enter()
+{
+	RECORD* pRecord = GetRecord();
+	if (pRecord->_nest++ == 0)
+		InterlockedExchange64((PLONG64)&pRecord->_state, (LONG64)((_globalEpoch << 1) | 1));
+}
+
+inline void EpochManager::Leave()
+{
+	RECORD* pRecord = reinterpret_cast<RECORD*>(FlsGetValue(_flsIdx));
+	if (--pRecord->_nest == 0)
+		InterlockedExchange64((PLONG64)&pRecord->_state, (LONG64)(pRecord->_state & ~(UINT64)1));
+}
+
+inline bool EpochManager::TryAdvance()
+{
+	UINT64 epoch = _globalEpoch;
+	UINT64 state;
+	for (RECORD* pRecord = _recordHead; pRecord != nullptr; pRecord = pRecord->_next)
+	{
+		//  鼭  Epoch ӹ ִ 尡 ִٸ  Ұ
+		state = pRecord->_state;
+		if ((state & 1) && (state >> 1) != epoch)
+			return false;
+	}
+	InterlockedCompareExchange64((PLONG64)&_globalEpoch, (LONG64)(epoch + 1), (LONG64)epoch);
+	return true;
+}
+
+inline EpochManager::RECORD* EpochManager::GetRecord()
+{
+	RECORD* pRecord = reinterpret_cast<RECORD*>(FlsGetValue(_flsIdx));
+	if (pRecord != nullptr)
+		return pRecord;
+
+	//  尡   
+	for (pRecord = _recordHead; pRecord != nullptr; pRecord = pRecord->_next)
+	{
+		if (pRecord->_inUse == 0 && InterlockedCompareExchange(&pRecord->_inUse, 1, 0) == 0)
+			break;
+	}
+
+	if (pRecord == nullptr)
+	{
+		pRecord = new RECORD;
+		pRecord->_state = 0;
+		pRecord->_inUse = 1;
+		pRecord->_nest = 0;
+
+		//   Ƿ ±  Push
+		RECORD* bkHead;
+		do
+		{
+			bkHead = _recordHead;
+			pRecord->_next = bkHead;
+		} while (InterlockedCompareExchangePointer((PVOID*)&_recordHead, pRecord, bkHead) != bkHead);
+	}
+
+	FlsSetValue(_flsIdx, pRecord);
+	return pRecord;
+}
+
+inline void WINAPI EpochManager::ReleaseRecord(PVOID pRecord)
+{
+	RECORD* pMyRecord = reinterpret_cast<RECORD*>(pRecord);
+	pMyRecord->_nest = 0;
+	InterlockedExchange64((PLONG64)&pMyRecord->_state, 0);
+	InterlockedExchange(&pMyRecord->_inUse, 0);
+}
@@ -0,0 +1,478 @@
+#pragma once
+#include "MemoryPool.h"
+#include "PoolRegistry.h"
+#ifdef IOBUFFERPOOL_USE_IORING
+#include <ioringapi.h>
+#endif // IOBUFFERPOOL_USE_IORING
+#define IO_BUFFER_ALIGN				4096
+#define NUM_OF_BUFFER_IN_CHUNK		64
+#define IO_BUFFER_REGISTER_USERDATA	0xFFFFFFFFFFFFFFFF
+
+/*
+# I/O Ǯ(IoBufferPoolTLS)
+
+MemoryPoolTLS  Chunk + TLS  BufferSize(4KB ) ũ ۸ Ҵմϴ.
+ ۴     /Ŀ    ķ ̸
+   ۿ  ιǷ  ü I/O   ֽϴ.
+
+ ȣ(GetBufferIndex) Ǯ ִ   Ƿ
+- IoRing(Windows 11) : IOBUFFERPOOL_USE_IORING defineϰ RegisterIoRing    
+                       GetBufferRef  IORING_BUFFER_REF BuildIoRingReadFile  
+- Registered I/O     : GetRegion/GetRegionSize  RIORegisterBuffer    
+                       RIO_BUF Offset GetBufferOffset 
+   I/O   ʰ   ֽϴ.
+
+Ȯ Ҵ  Ƿ bufferNum   ̸ Alloc nullptr ȯմϴ.
+۴  û 忡 Ҵǰ Ϸ 忡 ȯǹǷ
+-   Chunk  Free ٸ ʰ ٷ FreeStack ѱ
+- FreeStack  ٸ 尡 ĳ  Chunk   ۸ մϴ.
+̸   Chunk CACHE_SLOT ΰ ϴ  θ(긶 Interlocked 1ȸ)
+ִ   尡  ̹Ƿ ٸ 尡  ʽϴ.
+*/
+
+template <size_t BufferSize = IO_BUFFER_ALIGN, size_t ChunkSize = NUM_OF_BUFFER_IN_CHUNK>
+class IoBufferPoolTLS
+{
+	static_assert(BufferSize % IO_BUFFER_ALIGN == 0, "BufferSize must be a multiple of 4KB.");
+private:
+	//   , _descArray[i] i ۸ Ÿ
+	struct DESC
+	{
+		DESC*	_next;
+#ifndef MEMORYPOOL_MODE_RELEASE
+		code_t	_code;		// Ҵ ̸ _myCode, ȯ ¸ ~_myCode
+#endif // !MEMORYPOOL_MODE_RELEASE
+	};
+
+	//    ChunkSize   ִ Ŭ
+	class Chunk
+	{
+	public:
+		Chunk();
+		~Chunk() {}
+		bool Push(DESC* pDesc);
+		bool Pop(DESC** pDestDesc);
+		bool isEmpty() { return _size == 0; }
+		bool isFull() { return _size == ChunkSize; }
+	public:
+		volatile Chunk* _next;
+		DESC*			_freeStackTop;
+	private:
+		UINT64			_size;
+	};
+
+	// 庰 Chunk  ,  ʰ    
+	struct CACHE_SLOT
+	{
+		Chunk* volatile	_chunk;		//  尡  ̰ų ĳð  nullptr
+		volatile LONG	_inUse;
+		CACHE_SLOT*		_next;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////
+public:
+	IoBufferPoolTLS() = delete;
+	IoBufferPoolTLS(UINT32 bufferNum);
+	~IoBufferPoolTLS();
+	char* Alloc();
+	bool Free(char* pBuffer);
+
+	// Ͽ 
+	char* GetRegion() { return _region; }
+	UINT64 GetRegionSize() { return (UINT64)_bufferNum * BufferSize; }
+	UINT32 GetBufferNum() { return _bufferNum; }
+	UINT32 GetBufferIndex(const char* pBuffer) { return (UINT32)((pBuffer - _region) / BufferSize); }
+	UINT64 GetBufferOffset(const char* pBuffer) { return (UINT64)(pBuffer - _region); }
+	char* GetBuffer(UINT32 bufferIdx) { return _region + (UINT64)bufferIdx * BufferSize; }
+#ifdef IOBUFFERPOOL_USE_IORING
+	HRESULT RegisterIoRing(HIORING ioRing);	// ٸ û ֱ    ȣ
+	IORING_BUFFER_REF GetBufferRef(const char* pBuffer, UINT32 offset = 0)
+	{
+		return IoRingBufferRefFromIndexAndOffset(GetBufferIndex(pBuffer), offset);
+	}
+#endif // IOBUFFERPOOL_USE_IORING
+private:
+	void BufferFree(DESC* pDesc);
+	Chunk* ChunkAlloc();
+	void ChunkFree(Chunk* pChunk);
+	Chunk* StealChunk(CACHE_SLOT* pMySlot);	// ٸ   Chunk 
+	CACHE_SLOT* GetSlot();
+	// Chunk FreeStack
+	void Push(Chunk* pChunk);
+	bool Pop(Chunk** pDestChunk);
+	//    PoolRegistry ȣ
+	static void ReleaseTlsChunk(void* pOwner, void* pCache);
+private:
+	// Buffer Region,  ĵ  
+	char*		_region;
+	DESC*		_descArray;
+	UINT32		_bufferNum;
+
+	// ChunkManager,  Chunk Ҵ ȯ 
+	MemoryPool<Chunk>*	_emptyChunkManager;
+
+	// Chunk FreeStack, ۷    Chunk 
+	volatile Chunk* _freeStackTop;
+
+	//   CACHE_SLOT 
+	CACHE_SLOT* volatile	_slotHead;
+
+	//	COMMON, PoolRegistry Ű
+	poolkey_t		_chunkKey;
+
+#ifndef MEMORYPOOL_MODE_RELEASE
+	// Debugging
+	static code_t	secure_code;
+	code_t			_myCode;
+#endif // !MEMORYPOOL_MODE_RELEASE
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+#ifndef MEMORYPOOL_MODE_RELEASE
+template <size_t BufferSize, size_t ChunkSize>
+code_t IoBufferPoolTLS<BufferSize, ChunkSize>::secure_code = 0;
+#endif // !MEMORYPOOL_MODE_RELEASE
+
+template <size_t BufferSize, size_t ChunkSize>
+IoBufferPoolTLS<BufferSize, ChunkSize>::IoBufferPoolTLS(UINT32 bufferNum)
+	:_region(nullptr), _descArray(nullptr), _bufferNum(bufferNum), _freeStackTop(nullptr), _slotHead(nullptr)
+{
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	if ((__int64)si.lpMaximumApplicationAddress != 0x00007FFFFFFEFFFF)
+		throw L"It does not work with the current version of the current OS.";
+
+	if (bufferNum == 0)
+		throw L"Error: Parameter is not correct.";
+
+#ifndef MEMORYPOOL_MODE_RELEASE
+	_myCode = InterlockedIncrement64((PLONG64)&secure_code);
+#endif // !MEMORYPOOL_MODE_RELEASE
+
+	// VirtualAlloc Ҵ (64KB) ĵǹǷ  ۰  ĵ
+	_region = reinterpret_cast<char*>(VirtualAlloc(NULL, (size_t)bufferNum * BufferSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+	if (_region == nullptr)
+		throw GetLastError();
+
+	_descArray = reinterpret_cast<DESC*>(_aligned_malloc(sizeof(DESC) * bufferNum, alignof(DESC)));
+	if (_descArray == nullptr)
+	{
+		VirtualFree(_region, 0, MEM_RELEASE);
+		throw L"Error: Failed to allocate buffer descriptors.";
+	}
+
+	UINT64 chunkCnt = (bufferNum + (ChunkSize - 1)) / ChunkSize;
+	_emptyChunkManager = new MemoryPool<Chunk>(chunkCnt + si.dwNumberOfProcessors, POOL_MAX_ALLOC, false);
+	_chunkKey = PoolRegistry::Acquire(this, ReleaseTlsChunk);
+
+	//  ȣ  Chunk ä
+	Chunk* pChunk;
+	for (UINT64 i = 0; i < chunkCnt; i++)
+	{
+		pChunk = _emptyChunkManager->Alloc();
+		UINT64 edIdx = ChunkSize * (i + 1) < bufferNum ? ChunkSize * (i + 1) : bufferNum;
+		for (UINT64 j = edIdx; j > ChunkSize * i; j--)
+		{
+#ifndef MEMORYPOOL_MODE_RELEASE
+			_descArray[j - 1]._code = ~_myCode;
+#endif // !MEMORYPOOL_MODE_RELEASE
+			pChunk->Push(&_descArray[j - 1]);
+		}
+
+		pChunk->_next = _freeStackTop;
+		_freeStackTop = pChunk;
+	}
+}
+
+template <size_t BufferSize, size_t ChunkSize>
+IoBufferPoolTLS<BufferSize, ChunkSize>::~IoBufferPoolTLS()
+{
+	//   尡 ĳø ݳ ʵ  
+	PoolRegistry::Release(_chunkKey);
+
+	CACHE_SLOT* pSlot = _slotHead;
+	CACHE_SLOT* pNext;
+	while (pSlot != nullptr)
+	{
+		pNext = pSlot->_next;
+		delete pSlot;
+		pSlot = pNext;
+	}
+
+	VirtualFree(_region, 0, MEM_RELEASE);
+	_aligned_free(_descArray);
+	delete _emptyChunkManager;
+}
+
+template <size_t BufferSize, size_t ChunkSize>
+char* IoBufferPoolTLS<BufferSize, ChunkSize>::Alloc()
+{
+	DESC* pPopedDesc;
+
+	// ϴ  ٸ 尡  ϵ  
+	CACHE_SLOT* pSlot = GetSlot();
+	Chunk* pTlsChunk = reinterpret_cast<Chunk*>(InterlockedExchangePointer((PVOID*)&pSlot->_chunk, nullptr));
+
+	// Chunk  Ҵ
+	if (pTlsChunk != nullptr && !pTlsChunk->Pop(&pPopedDesc))
+	{
+		//   Chunk ȯ
+		_emptyChunkManager->Free(pTlsChunk);
+		pTlsChunk = nullptr;
+	}
+
+	if (pTlsChunk == nullptr)
+	{
+		//  Chunk Ҵ, FreeStack ִٸ ٸ  Chunk   
+		pTlsChunk = ChunkAlloc();
+		if (pTlsChunk == nullptr)
+			pTlsChunk = StealChunk(pSlot);
+		//  ۰   
+		if (pTlsChunk == nullptr)
+			return nullptr;
+		pTlsChunk->Pop(&pPopedDesc);
+	}
+	pSlot->_chunk = pTlsChunk;
+
+#ifndef MEMORYPOOL_MODE_RELEASE
+	// Ҵ · ȯ
+	pPopedDesc->_code = _myCode;
+#endif // !MEMORYPOOL_MODE_RELEASE
+
+	return GetBuffer((UINT32)(pPopedDesc - _descArray));
+}
+
+template <size_t BufferSize, size_t ChunkSize>
+bool IoBufferPoolTLS<BufferSize, ChunkSize>::Free(char* pBuffer)
+{
+	//  ̰ų   ּҰ ƴ 
+	UINT64 offset = (UINT64)(pBuffer - _region);
+	if (pBuffer < _region || offset >= GetRegionSize() || offset % BufferSize != 0)
+		return false;
+
+	DESC* pDesc = &_descArray[offset / BufferSize];
+
+#ifndef MEMORYPOOL_MODE_RELEASE
+	// ߺ ȯ ˻
+	if (pDesc->_code != _myCode)
+		return false;
+
+	// ȯ · ȯ
+	pDesc->_code = ~_myCode;
+#endif // !MEMORYPOOL_MODE_RELEASE
+
+	BufferFree(pDesc);
+	return true;
+}
+
+#ifdef IOBUFFERPOOL_USE_IORING
+template <size_t BufferSize, size_t ChunkSize>
+HRESULT IoBufferPoolTLS<BufferSize, ChunkSize>::RegisterIoRing(HIORING ioRing)
+{
+	//  ȣ ״ IoRing  ȣ 
+	IORING_BUFFER_INFO* pBufferInfo = new IORING_BUFFER_INFO[_bufferNum];
+	for (UINT32 i = 0; i < _bufferNum; i++)
+	{
+		pBufferInfo[i].Address = GetBuffer(i);
+		pBufferInfo[i].Length = (UINT32)BufferSize;
+	}
+
+	HRESULT hr = BuildIoRingRegisterBuffers(ioRing, _bufferNum, pBufferInfo, IO_BUFFER_REGISTER_USERDATA);
+	if (SUCCEEDED(hr))
+	{
+		UINT32 submitted;
+		hr = SubmitIoRing(ioRing, 1, INFINITE, &submitted);
+	}
+
+	if (SUCCEEDED(hr))
+	{
+		IORING_CQE cqe;
+		hr = PopIoRingCompletion(ioRing, &cqe);
+		if (SUCCEEDED(hr))
+			hr = cqe.ResultCode;
+	}
+
+	delete[] pBufferInfo;
+	return hr;
+}
+#endif // IOBUFFERPOOL_USE_IORING
+
+template <size_t BufferSize, size_t ChunkSize>
+void IoBufferPoolTLS<BufferSize, ChunkSize>::BufferFree(DESC* pDesc)
+{
+	CACHE_SLOT* pSlot = GetSlot();
+	Chunk* pTlsChunk = reinterpret_cast<Chunk*>(InterlockedExchangePointer((PVOID*)&pSlot->_chunk, nullptr));
+	if (pTlsChunk == nullptr)
+	{
+		//   Chunk Ҵ
+		pTlsChunk = _emptyChunkManager->Alloc();
+	}
+
+	if (!pTlsChunk->Push(pDesc))
+	{
+		ChunkFree(pTlsChunk);
+		pTlsChunk = _emptyChunkManager->Alloc();
+		pTlsChunk->Push(pDesc);
+	}
+
+	//   Chunk  Free   ʰ ٷ FreeStack ѱ
+	if (pTlsChunk->isFull())
+	{
+		ChunkFree(pTlsChunk);
+		pTlsChunk = nullptr;
+	}
+	pSlot->_chunk = pTlsChunk;
+}
+
+template <size_t BufferSize, size_t ChunkSize>
+typename IoBufferPoolTLS<BufferSize, ChunkSize>::Chunk* IoBufferPoolTLS<BufferSize, ChunkSize>::ChunkAlloc()
+{
+	Chunk* popChunk = nullptr;
+	if (!Pop(&popChunk))
+		return nullptr;
+	return popChunk;
+}
+
+template <size_t BufferSize, size_t ChunkSize>
+void IoBufferPoolTLS<BufferSize, ChunkSize>::ChunkFree(Chunk* pChunk)
+{
+	Push(pChunk);
+}
+
+template <size_t BufferSize, size_t ChunkSize>
+typename IoBufferPoolTLS<BufferSize, ChunkSize>::Chunk* IoBufferPoolTLS<BufferSize, ChunkSize>::StealChunk(CACHE_SLOT* pMySlot)
+{
+	Chunk* pChunk;
+	for (CACHE_SLOT* pSlot = _slotHead; pSlot != nullptr; pSlot = pSlot->_next)
+	{
+		// ִ  ĳð ų  尡  
+		if (pSlot == pMySlot || pSlot->_chunk == nullptr)
+			continue;
+		pChunk = reinterpret_cast<Chunk*>(InterlockedExchangePointer((PVOID*)&pSlot->_chunk, nullptr));
+		if (pChunk == nullptr)
+			continue;
+		if (!pChunk->isEmpty())
+			return pChunk;
+		//    꿡  Chunk 
+		_emptyChunkManager->Free(pChunk);
+	}
+	return nullptr;
+}
+
+template <size_t BufferSize, size_t ChunkSize>
+typename IoBufferPoolTLS<BufferSize, ChunkSize>::CACHE_SLOT* IoBufferPoolTLS<BufferSize, ChunkSize>::GetSlot()
+{
+	CACHE_SLOT* pSlot = reinterpret_cast<CACHE_SLOT*>(PoolRegistry::GetCache(_chunkKey));
+	if (pSlot != nullptr)
+		return pSlot;
+
+	//    
+	for (pSlot = _slotHead; pSlot != nullptr; pSlot = pSlot->_next)
+	{
+		if (pSlot->_inUse == 0 && InterlockedCompareExchange(&pSlot->_inUse, 1, 0) == 0)
+			break;
+	}
+
+	if (pSlot == nullptr)
+	{
+		pSlot = new CACHE_SLOT;
+		pSlot->_chunk = nullptr;
+		pSlot->_inUse = 1;
+
+		//  Ǯ Ҹ   Ƿ ±  Push
+		CACHE_SLOT* bkHead;
+		do
+		{
+			bkHead = _slotHead;
+			pSlot->_next = bkHead;
+		} while (InterlockedCompareExchangePointer((PVOID*)&_slotHead, pSlot, bkHead) != bkHead);
+	}
+
+	PoolRegistry::SetCache(_chunkKey, pSlot);
+	return pSlot;
+}
+
+template <size_t BufferSize, size_t ChunkSize>
+void IoBufferPoolTLS<BufferSize, ChunkSize>::ReleaseTlsChunk(void* pOwner, void* pCache)
+{
+	IoBufferPoolTLS* pPool = reinterpret_cast<IoBufferPoolTLS*>(pOwner);
+	CACHE_SLOT* pSlot = reinterpret_cast<CACHE_SLOT*>(pCache);
+
+	// ٸ 尡 ̹   
+	Chunk* pChunk = reinterpret_cast<Chunk*>(InterlockedExchangePointer((PVOID*)&pSlot->_chunk, nullptr));
+	if (pChunk != nullptr)
+	{
+		// ۰ ִٸ   ʾҴ FreeStack ȯ
+		if (pChunk->isEmpty())
+			pPool->_emptyChunkManager->Free(pChunk);
+		else
+			pPool->ChunkFree(pChunk);
+	}
+	InterlockedExchange(&pSlot->_inUse, 0);
+}
+
+template <size_t BufferSize, size_t ChunkSize>
+void IoBufferPoolTLS<BufferSize, ChunkSize>::Push(Chunk* pChunk)
+{
+	volatile UINT64 idx;
+	volatile Chunk* bkTop;
+	while (1)
+	{
+		bkTop = _freeStackTop;
+		idx = (UINT64)bkTop >> 47;
+		pChunk->_next = (Chunk*)((UINT64)bkTop & 0x00007FFFFFFFFFFF);
+		if (InterlockedCompareExchange64((PLONG64)&_freeStackTop, (LONG64)pChunk | ((UINT64)idx << 47), (LONG64)bkTop) == (LONG64)bkTop)
+			break;
+	}
+}
+
+template <size_t BufferSize, size_t ChunkSize>
+bool IoBufferPoolTLS<BufferSize, ChunkSize>::Pop(Chunk** pDestChunk)
+{
+	volatile void* bkTop;
+	volatile UINT64 idx;
+	Chunk* popNode;
+	volatile Chunk* nextTop;
+	while (1)
+	{
+		bkTop = _freeStackTop;
+		idx = ((UINT64)bkTop >> 47) + 1;
+		popNode = (Chunk*)((UINT64)bkTop & 0x00007FFFFFFFFFFF);
+		if (popNode == nullptr)
+			return false;
+
+		nextTop = popNode->_next;
+
+		if (InterlockedCompareExchange64((PLONG64)&_freeStackTop, (LONG64)nextTop | ((UINT64)idx << 47), (LONG64)bkTop) == (LONG64)bkTop)
+			break;
+	}
+	*pDestChunk = popNode;
+
+	return true;
+}
+///////////////////////////////////////////////////////////////////////////////////////
+/* Chunk Class */
+template <size_t BufferSize, size_t ChunkSize>
+IoBufferPoolTLS<BufferSize, ChunkSize>::Chunk::Chunk() :_size(0), _freeStackTop(nullptr), _next(nullptr) {}
+
+template <size_t BufferSize, size_t ChunkSize>
+bool IoBufferPoolTLS<BufferSize, ChunkSize>::Chunk::Push(DESC* pDesc)
+{
+	if (isFull())
+		return false;
+	pDesc->_next = _freeStackTop;
+	_freeStackTop = pDesc;
+	++_size;
+	return true;
+}
+
+template <size_t BufferSize, size_t ChunkSize>
+bool IoBufferPoolTLS<BufferSize, ChunkSize>::Chunk::Pop(DESC** pDestDesc)
+{
+	if (isEmpty())
+		return false;
+	*pDestDesc = _freeStackTop;
+	_freeStackTop = _freeStackTop->_next;
+	--_size;
+	return true;
+}
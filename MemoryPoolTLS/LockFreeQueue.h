@@ -0,0 +1,146 @@
+#pragma once
+#include "MemoryPoolTLS.h"
+
+// 带 MemoryPoolTLS Ҵ޴ LockFree ť(Michael-Scott)
+// Head, Tail  带  ϸ   17bit ±׷ ABA  ȸ
+//    RetireEpoch ȯϹǷ EpochGuard  ȿ  
+
+template <class T, size_t ChunkSize = NUM_OF_BLOCK_IN_CHUNK>
+class LockFreeQueue
+{
+private:
+	struct NODE
+	{
+		NODE() :_data(), _next(nullptr) {}
+		NODE(const T& data) :_data(data), _next(nullptr) {}
+		T		_data;
+		NODE* volatile	_next;
+	};
+public:
+	LockFreeQueue(UINT64 initNodeNum = 0, UINT64 maxNodeLimit = POOL_MAX_ALLOC);
+	~LockFreeQueue();
+	bool Enqueue(const T& data);
+	bool Dequeue(T* pDestData);
+	// Enqueue/Dequeue ̿ īͰ     Ƿ 0 
+	UINT64 GetSize() { LONG64 size = _size; return size > 0 ? (UINT64)size : 0; }
+	bool IsEmpty() { return _size <= 0; }
+private:
+	volatile NODE*	_head;
+	volatile NODE*	_tail;
+	volatile LONG64	_size;
+
+	//  Ҵ 
+	MemoryPoolTLS<NODE, ChunkSize>*	_nodePool;
+};
+
+template <class T, size_t ChunkSize>
+LockFreeQueue<T, ChunkSize>::LockFreeQueue(UINT64 initNodeNum, UINT64 maxNodeLimit)
+	:_size(0)
+{
+	//    1  Ҵ
+	_nodePool = new MemoryPoolTLS<NODE, ChunkSize>(initNodeNum + 1, maxNodeLimit + 1, true);
+
+	NODE* pDummy = _nodePool->Alloc();
+	if (pDummy == nullptr)
+		throw L"Error: Failed to allocate dummy node.";
+	_head = pDummy;
+	_tail = pDummy;
+}
+
+template <class T, size_t ChunkSize>
+LockFreeQueue<T, ChunkSize>::~LockFreeQueue()
+{
+	//  带 Ͽ ִ  ȯ
+	NODE* pNode = (NODE*)((UINT64)_head & 0x00007FFFFFFFFFFF);
+	NODE* pNext;
+	while (pNode != nullptr)
+	{
+		pNext = pNode->_next;
+		_nodePool->Free(pNode);
+		pNode = pNext;
+	}
+	delete _nodePool;
+}
+
+template <class T, size_t ChunkSize>
+bool LockFreeQueue<T, ChunkSize>::Enqueue(const T& data)
+{
+	NODE* pNewNode = _nodePool->Alloc(data);
+	if (pNewNode == nullptr)
+		return false;
+
+	volatile void* bkTail;
+	UINT64 idx;
+	NODE* pTail;
+	NODE* pNext;
+	EpochGuard guard;
+	while (1)
+	{
+		bkTail = _tail;
+		idx = ((UINT64)bkTail >> 47) + 1;
+		pTail = (NODE*)((UINT64)bkTail & 0x00007FFFFFFFFFFF);
+		pNext = pTail->_next;
+
+		if (bkTail != _tail)
+			continue;
+
+		if (pNext == nullptr)
+		{
+			if (InterlockedCompareExchangePointer((PVOID*)&pTail->_next, pNewNode, nullptr) == nullptr)
+			{
+				// ϴ ٸ 尡 Tail о
+				InterlockedCompareExchange64((PLONG64)&_tail, (LONG64)pNewNode | ((UINT64)idx << 47), (LONG64)bkTail);
+				break;
+			}
+		}
+		else
+		{
+			// Tail  带 Ű ʴ   о
+			InterlockedCompareExchange64((PLONG64)&_tail, (LONG64)pNext | ((UINT64)idx << 47), (LONG64)bkTail);
+		}
+	}
+	InterlockedIncrement64(&_size);
+	return true;
+}
+
+template <class T, size_t ChunkSize>
+bool LockFreeQueue<T, ChunkSize>::Dequeue(T* pDestData)
+{
+	volatile void* bkHead;
+	volatile void* bkTail;
+	UINT64 headIdx;
+	NODE* pHead;
+	NODE* pNext;
+	EpochGuard guard;
+	while (1)
+	{
+		bkHead = _head;
+		bkTail = _tail;
+		headIdx = ((UINT64)bkHead >> 47) + 1;
+		pHead = (NODE*)((UINT64)bkHead & 0x00007FFFFFFFFFFF);
+		pNext = pHead->_next;
+
+		if (bkHead != _head)
+			continue;
+
+		if (pNext == nullptr)
+			return false;
+
+		// Tail ó ä Head ռ  ̸ Tail Ű ǹǷ Tail о
+		if (pHead == (NODE*)((UINT64)bkTail & 0x00007FFFFFFFFFFF))
+		{
+			InterlockedCompareExchange64((PLONG64)&_tail, (LONG64)pNext | ((((UINT64)bkTail >> 47) + 1) << 47), (LONG64)bkTail);
+			continue;
+		}
+
+		if (InterlockedCompareExchange64((PLONG64)&_head, (LONG64)pNext | ((UINT64)headIdx << 47), (LONG64)bkHead) == (LONG64)bkHead)
+			break;
+	}
+	InterlockedDecrement64(&_size);
+
+	// pNext ٸ 尡 ̹ ȸ ״ guard Ǵ  ȿ
+	*pDestData = pNext->_data;
+	//    ȯ, pNext  ̰ 
+	_nodePool->RetireEpoch(pHead);
+	return true;
+}
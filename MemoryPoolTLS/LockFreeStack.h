@@ -0,0 +1,104 @@
+#pragma once
+#include "MemoryPoolTLS.h"
+
+// 带 MemoryPoolTLS Ҵ޴ LockFree 
+// ABA  Top   17bit ±׷ ȸϰ
+// Pop  RetireEpoch ȯϿ ٸ 尡 д   ʵ 
+
+template <class T, size_t ChunkSize = NUM_OF_BLOCK_IN_CHUNK>
+class LockFreeStack
+{
+private:
+	struct NODE
+	{
+		NODE() :_data(), _next(nullptr) {}
+		NODE(const T& data) :_data(data), _next(nullptr) {}
+		T		_data;
+		NODE*	_next;
+	};
+public:
+	LockFreeStack(UINT64 initNodeNum = 0, UINT64 maxNodeLimit = POOL_MAX_ALLOC);
+	~LockFreeStack();
+	bool Push(const T& data);
+	bool Pop(T* pDestData);
+	// Push/Pop ̿ īͰ     Ƿ 0 
+	UINT64 GetSize() { LONG64 size = _size; return size > 0 ? (UINT64)size : 0; }
+	bool IsEmpty() { return _size <= 0; }
+private:
+	volatile NODE*	_top;
+	volatile LONG64	_size;
+
+	//  Ҵ 
+	MemoryPoolTLS<NODE, ChunkSize>*	_nodePool;
+};
+
+template <class T, size_t ChunkSize>
+LockFreeStack<T, ChunkSize>::LockFreeStack(UINT64 initNodeNum, UINT64 maxNodeLimit)
+	:_top(nullptr), _size(0)
+{
+	_nodePool = new MemoryPoolTLS<NODE, ChunkSize>(initNodeNum, maxNodeLimit, true);
+}
+
+template <class T, size_t ChunkSize>
+LockFreeStack<T, ChunkSize>::~LockFreeStack()
+{
+	// ִ  Ҹ ȣ
+	NODE* pNode = (NODE*)((UINT64)_top & 0x00007FFFFFFFFFFF);
+	NODE* pNext;
+	while (pNode != nullptr)
+	{
+		pNext = pNode->_next;
+		_nodePool->Free(pNode);
+		pNode = pNext;
+	}
+	delete _nodePool;
+}
+
+template <class T, size_t ChunkSize>
+bool LockFreeStack<T, ChunkSize>::Push(const T& data)
+{
+	NODE* pNewNode = _nodePool->Alloc(data);
+	if (pNewNode == nullptr)
+		return false;
+
+	UINT64 idx;
+	volatile NODE* bkTop;
+	while (1)
+	{
+		bkTop = _top;
+		idx = (UINT64)bkTop >> 47;
+		pNewNode->_next = (NODE*)((UINT64)bkTop & 0x00007FFFFFFFFFFF);
+		if (InterlockedCompareExchange64((PLONG64)&_top, (LONG64)pNewNode | ((UINT64)idx << 47), (LONG64)bkTop) == (LONG64)bkTop)
+			break;
+	}
+	InterlockedIncrement64(&_size);
+	return true;
+}
+
+template <class T, size_t ChunkSize>
+bool LockFreeStack<T, ChunkSize>::Pop(T* pDestData)
+{
+	volatile void* bkTop;
+	UINT64 idx;
+	NODE* popNode;
+	NODE* nextTop;
+	EpochGuard guard;
+	while (1)
+	{
+		bkTop = _top;
+		idx = ((UINT64)bkTop >> 47) + 1;
+		popNode = (NODE*)((UINT64)bkTop & 0x00007FFFFFFFFFFF);
+		if (popNode == nullptr)
+			return false;
+
+		nextTop = popNode->_next;
+
+		if (InterlockedCompareExchange64((PLONG64)&_top, (LONG64)nextTop | ((UINT64)idx << 47), (LONG64)bkTop) == (LONG64)bkTop)
+			break;
+	}
+	InterlockedDecrement64(&_size);
+
+	*pDestData = popNode->_data;
+	_nodePool->RetireEpoch(popNode);
+	return true;
+}
@@ -1,5 +1,14 @@
 #pragma once
 #include "MemoryPool.h"
+#include "EpochManager.h"
+#include "PoolRegistry.h"
+#ifdef MEMORYPOOL_TRACE
+#include "AllocTracer.h"
+#ifndef MEMORYPOOL_COUNT_CAS
+#define MEMORYPOOL_COUNT_CAS	//   Chunk FreeStack CAS Ƚ Բ 
+#endif // !MEMORYPOOL_COUNT_CAS
+#endif // MEMORYPOOL_TRACE
+#pragma comment(lib, "Synchronization.lib")	// WaitOnAddress
 #define NUM_OF_BLOCK_IN_CHUNK	400
 #define POOL_MAX_ALLOC			0xFFFFFFFFFFFFFFF
 //#define MEMORYPOOL_MODE_RELEASE
@@ -29,7 +38,6 @@ private:
 		~Chunk() {}
 		bool Push(BLOCK* pBlock);
 		bool Pop(BLOCK** pDestBlock);
-	private:
 		bool isEmpty() { return _size == 0; }
 		bool isFull() { return _size == ChunkSize; }
 	public:
@@ -59,6 +67,18 @@ private:
 		volatile NODE*	_allocTop;
 	};
 
+	// Epoch ȸ   , Epoch % 3 ġ 
+	struct RETIRE_LIST
+	{
+		RETIRE_LIST() :_head(), _epoch(), _count(0), _next(nullptr), _allNext(nullptr), _isLinked(false) {}
+		BLOCK*	_head[3];
+		UINT64	_epoch[3];
+		UINT64	_count;
+		volatile RETIRE_LIST* _next;
+		RETIRE_LIST*	_allNext;	// Ǯ Ҹ  ȸ, ѹ Ǹ  
+		bool			_isLinked;
+	};
+
 	////////////////////////////////////////////////////////////////////////////////////////////////////
 public:
 	MemoryPoolTLS() = delete;
@@ -67,14 +87,34 @@ public:
 	~MemoryPoolTLS();
 	template <typename... Types>
 	T* Alloc(Types... args);
+	template <typename... Types>
+	T* AllocWait(DWORD timeout, Types... args);	// maxBlockLimit ϸ ȯ  (ms),   ĳÿ   ٸ 
 	bool Free(T* data);
+	bool RetireEpoch(T* data);	//   ȯ(EpochGuard  б ȣ)
+	void ReclaimRetired();		//     ȸ      ȯ
+#ifdef MEMORYPOOL_TRACE
+	UINT16 GetTracePoolId() { return _tracePoolId; }
+#endif // MEMORYPOOL_TRACE
+#ifdef MEMORYPOOL_COUNT_CAS
+	UINT64 GetChunkStackCasCount() { return _casCnt; }
+	UINT64 GetChunkStackCasFailCount() { return _casFailCnt; }
+#endif // MEMORYPOOL_COUNT_CAS
 private:
+	void BlockFree(BLOCK* pBlock);
+	void Reclaim(RETIRE_LIST* pList, UINT64 slot);
 	template <typename... Types>
 	Chunk* ChunkAlloc(Types... args); // Freelist  
+	bool IsExhausted() { return _addAllocCnt + 1 >= _addAllocMax; }	//  ̻ Ȯ   
 	void ChunkFree(Chunk* pChunk);
 	// Chunk FreeStack
 	void Push(Chunk* pChunk);
 	bool Pop(Chunk** pDestChunk);
+	// Orphan RetireList Stack
+	void PushOrphan(RETIRE_LIST* pList);
+	bool PopOrphan(RETIRE_LIST** pDestList);
+	//    PoolRegistry ȣ
+	static void ReleaseTlsChunk(void* pOwner, void* pCache);
+	static void ReleaseRetireList(void* pOwner, void* pCache);
 private:
 	// Block Pool
 	BLOCK*	_blockPool;
@@ -90,14 +130,27 @@ private:
 	// ChunkManager,  Chunk Ҵ ȯ 
 	MemoryPool<Chunk>*	_emptyChunkManager;
 
+	// RetireListManager, 庰 ȸ   Ҵ 
+	MemoryPool<RETIRE_LIST>*	_retireListManager;
+
 	// Chunk FreeStack, Block    Chunk 
 	volatile Chunk* _freeStackTop;
 
+	// Orphan RetireList Stack,  尡  ȸ   
+	volatile RETIRE_LIST* _orphanTop;
+
+	// Ҵ  ִ  ȸ  , Ҹ     
+	RETIRE_LIST* volatile	_retireListHead;
+
+	// AllocWait   , 0 ƴ  Free Chunk ѱ 
+	volatile LONG	_waiterCnt;
+
 	// Setting
 	const bool		_isPlacementNew;
 
-	//	COMMON
-	DWORD			_tlsIdx;
+	//	COMMON, PoolRegistry Ű
+	poolkey_t		_chunkKey;
+	poolkey_t		_retireKey;
 
 #ifndef MEMORYPOOL_MODE_RELEASE
 	// Debugging
@@ -106,6 +159,16 @@ private:
 	UINT64			_useChunk;
 	code_t			_myCode;
 #endif // !MEMORYPOOL_MODE_RELEASE
+
+#ifdef MEMORYPOOL_TRACE
+	// Tracing
+	UINT16			_tracePoolId;
+#endif // MEMORYPOOL_TRACE
+#ifdef MEMORYPOOL_COUNT_CAS
+	// Chunk FreeStack CAS õ/ Ƚ
+	UINT64			_casCnt;
+	UINT64			_casFailCnt;
+#endif // MEMORYPOOL_COUNT_CAS
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -117,7 +180,7 @@ code_t MemoryPoolTLS<T, ChunkSize>::secure_code = 0;
 template <class T, size_t ChunkSize>
 template <typename... Types>
 MemoryPoolTLS<T, ChunkSize>::MemoryPoolTLS(UINT64 initBlockNum, UINT64 maxBlockLimit, bool isPlacementNew, Types... args)
-	:_isPlacementNew(isPlacementNew), _freeStackTop(nullptr), _addAllocCnt(-1), _allocAddr(nullptr)
+	:_isPlacementNew(isPlacementNew), _freeStackTop(nullptr), _addAllocCnt(-1), _allocAddr(nullptr), _waiterCnt(0)
 {
 	SYSTEM_INFO si;
 	GetSystemInfo(&si);
@@ -130,7 +193,19 @@ MemoryPoolTLS<T, ChunkSize>::MemoryPoolTLS(UINT64 initBlockNum, UINT64 maxBlockL
 	if (initBlockNum == 0 && maxBlockLimit == 0)
 		throw L"Error: Parameter is not correct.";
 
-	_tlsIdx = TlsAlloc();
+#ifdef MEMORYPOOL_TRACE
+	// Ǯ   ܰ ߻  Ƿ PoolRegistry Ű  
+	_tracePoolId = AllocTracer::GetInstance()->RegisterPool(sizeof(T), ChunkSize);
+#endif // MEMORYPOOL_TRACE
+#ifdef MEMORYPOOL_COUNT_CAS
+	_casCnt = 0;
+	_casFailCnt = 0;
+#endif // MEMORYPOOL_COUNT_CAS
+
+	_orphanTop = nullptr;
+	_retireListHead = nullptr;
+	_chunkKey = PoolRegistry::Acquire(this, ReleaseTlsChunk);
+	_retireKey = PoolRegistry::Acquire(this, ReleaseRetireList);
 
 	UINT64 initChunkCnt = (initBlockNum + (ChunkSize - 1)) / ChunkSize;
 	UINT64 maxChunkCnt = (maxBlockLimit + (ChunkSize - 1)) / ChunkSize;
@@ -151,6 +226,9 @@ MemoryPoolTLS<T, ChunkSize>::MemoryPoolTLS(UINT64 initBlockNum, UINT64 maxBlockL
 	//  Chunk Ҵ ޸Ǯ 
 	_emptyChunkManager = new MemoryPool<Chunk>(initChunkCnt + si.dwNumberOfProcessors, POOL_MAX_ALLOC, false);
 
+	// ȸ   Ҵ ޸Ǯ 
+	_retireListManager = new MemoryPool<RETIRE_LIST>(si.dwNumberOfProcessors, POOL_MAX_ALLOC, false);
+
 	// BlockPool 
 	if (initBlockNum == 0)	// ó FreeList ·  
 	{
@@ -195,6 +273,23 @@ MemoryPoolTLS<T, ChunkSize>::MemoryPoolTLS(UINT64 initBlockNum, UINT64 maxBlockL
 template <class T, size_t ChunkSize>
 MemoryPoolTLS<T, ChunkSize>::~MemoryPoolTLS()
 {
+	//   尡 ĳø ݳ ʵ  
+	PoolRegistry::Release(_chunkKey);
+	PoolRegistry::Release(_retireKey);
+
+	// ȸ   Ҹ ȣ, ٸ  ĳÿ  ϵ  Ǿ 
+	if (_isPlacementNew)
+	{
+		for (RETIRE_LIST* pList = _retireListHead; pList != nullptr; pList = pList->_allNext)
+		{
+			for (UINT64 slot = 0; slot < 3; slot++)
+			{
+				for (BLOCK* pBlock = pList->_head[slot]; pBlock != nullptr; pBlock = pBlock->_next)
+					pBlock->_data.~T();
+			}
+		}
+	}
+
 	if (_allocAddr != nullptr)
 		VirtualFree(_allocAddr, 0, MEM_RELEASE);
 
@@ -202,7 +297,11 @@ MemoryPoolTLS<T, ChunkSize>::~MemoryPoolTLS()
 		delete _addBlockArrAllocator;
 
 	delete		_emptyChunkManager;
-	TlsFree(_tlsIdx);
+	delete		_retireListManager;
+
+#ifdef MEMORYPOOL_TRACE
+	AllocTracer::GetInstance()->UnregisterPool(_tracePoolId);
+#endif // MEMORYPOOL_TRACE
 }
 
 template <class T, size_t ChunkSize>
@@ -211,11 +310,14 @@ T* MemoryPoolTLS<T, ChunkSize>::Alloc(Types... args)
 {
 	BLOCK* pPopedBlock;
 
-	Chunk* pTlsChunk = reinterpret_cast<Chunk*>(TlsGetValue(_tlsIdx));
+	Chunk* pTlsChunk = reinterpret_cast<Chunk*>(PoolRegistry::GetCache(_chunkKey));
 	if (pTlsChunk == nullptr)
 	{
 		pTlsChunk = ChunkAlloc(args...);
-		TlsSetValue(_tlsIdx, pTlsChunk);
+		//  ̻ Ȯ   
+		if (pTlsChunk == nullptr)
+			return nullptr;
+		PoolRegistry::SetCache(_chunkKey, pTlsChunk);
 	}
 
 	// Chunk Block Ҵ
@@ -225,8 +327,10 @@ T* MemoryPoolTLS<T, ChunkSize>::Alloc(Types... args)
 		_emptyChunkManager->Free(pTlsChunk);
 		//  Chunk Ҵ
 		pTlsChunk = ChunkAlloc(args...);
+		PoolRegistry::SetCache(_chunkKey, pTlsChunk);
+		if (pTlsChunk == nullptr)
+			return nullptr;
 		pTlsChunk->Pop(&pPopedBlock);
-		TlsSetValue(_tlsIdx, pTlsChunk);
 	}
 
 #ifndef MEMORYPOOL_MODE_RELEASE
@@ -234,12 +338,66 @@ T* MemoryPoolTLS<T, ChunkSize>::Alloc(Types... args)
 	pPopedBlock->_postCode = ~pPopedBlock->_postCode;
 #endif // !MEMORYPOOL_MODE_RELEASE
 
+#ifdef MEMORYPOOL_TRACE
+	AllocTracer::GetInstance()->Record(TRACE_OP_ALLOC, _tracePoolId, (UINT64)pPopedBlock);
+#endif // MEMORYPOOL_TRACE
+
 	if (_isPlacementNew)
 		return new (&pPopedBlock->_data) T(args...);
 	else
 		return &pPopedBlock->_data;
 }
 
+template <class T, size_t ChunkSize>
+template <typename... Types>
+T* MemoryPoolTLS<T, ChunkSize>::AllocWait(DWORD timeout, Types... args)
+{
+	T* pData = Alloc(args...);
+	if (pData != nullptr)
+		return pData;
+
+	// maxBlockLimit ѱ Ƿ FreeStack ƿ Chunk ٸ
+	//    Free Chunk ٷ ѱ, ̹ Free ġ  ִ  ĳÿ  
+	//  尡 ٽ Alloc/Freeϰų   ƿ Ƿ timeout Ͽ 
+	ULONGLONG deadline = GetTickCount64() + timeout;
+	ULONGLONG now;
+	DWORD waitTime;
+	volatile Chunk* bkTop;
+	while (1)
+	{
+		//    ø  FreeStack Ȯؾ Free ⸦ ġ 
+		InterlockedIncrement(&_waiterCnt);
+		bkTop = _freeStackTop;
+		if (((UINT64)bkTop & 0x00007FFFFFFFFFFF) == 0)
+		{
+			if (timeout == INFINITE)
+			{
+				waitTime = INFINITE;
+			}
+			else
+			{
+				now = GetTickCount64();
+				if (now >= deadline)
+				{
+					InterlockedDecrement(&_waiterCnt);
+					return nullptr;
+				}
+				waitTime = (DWORD)(deadline - now);
+			}
+			// ±  Push/Pop Ͼ  ݵ ٲ
+			WaitOnAddress(&_freeStackTop, (PVOID)&bkTop, sizeof(bkTop), waitTime);
+		}
+		InterlockedDecrement(&_waiterCnt);
+
+		pData = Alloc(args...);
+		if (pData != nullptr)
+			return pData;
+
+		if (timeout != INFINITE && GetTickCount64() >= deadline)
+			return nullptr;
+	}
+}
+
 template <class T, size_t ChunkSize>
 bool MemoryPoolTLS<T, ChunkSize>::Free(T* data)
 {
@@ -262,26 +420,186 @@ bool MemoryPoolTLS<T, ChunkSize>::Free(T* data)
 	BLOCK* pushNode = reinterpret_cast<BLOCK*>(data);
 #endif // !MEMORYPOOL_MODE_RELEASE
 
+#ifdef MEMORYPOOL_TRACE
+	AllocTracer::GetInstance()->Record(TRACE_OP_FREE, _tracePoolId, (UINT64)pushNode);
+#endif // MEMORYPOOL_TRACE
+
 	// Ҹ ȣ  
 	if (_isPlacementNew)
 		data->~T();
 
-	Chunk* pTlsChunk = reinterpret_cast<Chunk*>(TlsGetValue(_tlsIdx));
+	BlockFree(pushNode);
+	return true;
+}
+
+template <class T, size_t ChunkSize>
+bool MemoryPoolTLS<T, ChunkSize>::RetireEpoch(T* data)
+{
+#ifndef MEMORYPOOL_MODE_RELEASE
+	BLOCK* pushNode = reinterpret_cast<BLOCK*>(
+		reinterpret_cast<__int64>(data) - reinterpret_cast<__int64>(&((BLOCK*)0)->_data)
+		);
+
+	// ޸ ħ  ȿ ˻(Ҵ  ޸ ľ)
+	if (pushNode->_preCode != pushNode->_postCode)
+		return false;
+
+	// ٸ ޸Ǯ ȯϷϴ  ˻
+	if (pushNode->_preCode != _myCode)
+		return false;
+
+	// ȸ    ޸𸮷 Ͽ ߺ ȯ 
+	pushNode->_postCode = ~pushNode->_postCode;
+#else
+	BLOCK* pushNode = reinterpret_cast<BLOCK*>(data);
+#endif // !MEMORYPOOL_MODE_RELEASE
+
+#ifdef MEMORYPOOL_TRACE
+	AllocTracer::GetInstance()->Record(TRACE_OP_RETIRE, _tracePoolId, (UINT64)pushNode);
+#endif // MEMORYPOOL_TRACE
+
+	RETIRE_LIST* pList = reinterpret_cast<RETIRE_LIST*>(PoolRegistry::GetCache(_retireKey));
+	if (pList == nullptr)
+	{
+		pList = _retireListManager->Alloc();
+		PoolRegistry::SetCache(_retireKey, pList);
+
+		// Ǵ  ̹ Ǿ Ƿ ó Ҵ ϸ 
+		if (!pList->_isLinked)
+		{
+			pList->_isLinked = true;
+			RETIRE_LIST* bkHead;
+			do
+			{
+				bkHead = _retireListHead;
+				pList->_allNext = bkHead;
+			} while (InterlockedCompareExchangePointer((PVOID*)&_retireListHead, pList, bkHead) != bkHead);
+		}
+	}
+
+	EpochManager* pEpochManager = EpochManager::GetInstance();
+	UINT64 epoch = pEpochManager->GetEpoch();
+	UINT64 slot = epoch % 3;
+
+	//  ġ   3 Epoch ̻  ̹Ƿ ٷ ȯ 
+	if (pList->_epoch[slot] != epoch)
+	{
+		Reclaim(pList, slot);
+		pList->_epoch[slot] = epoch;
+	}
+
+	pushNode->_next = pList->_head[slot];
+	pList->_head[slot] = pushNode;
+	++pList->_count;
+
+	// Chunk ϳ з ̸ Epoch  õϰ ϰ ȯ
+	if (pList->_count >= ChunkSize)
+		ReclaimRetired();
+	return true;
+}
+
+template <class T, size_t ChunkSize>
+void MemoryPoolTLS<T, ChunkSize>::ReclaimRetired()
+{
+	EpochManager* pEpochManager = EpochManager::GetInstance();
+	pEpochManager->TryAdvance();
+
+	RETIRE_LIST* pList = reinterpret_cast<RETIRE_LIST*>(PoolRegistry::GetCache(_retireKey));
+	if (pList != nullptr)
+	{
+		for (UINT64 slot = 0; slot < 3; slot++)
+		{
+			if (pList->_head[slot] != nullptr && pEpochManager->IsSafe(pList->_epoch[slot]))
+				Reclaim(pList, slot);
+		}
+	}
+
+	//  尡     ϳ  ȸ
+	RETIRE_LIST* pOrphan;
+	if (PopOrphan(&pOrphan))
+	{
+		for (UINT64 slot = 0; slot < 3; slot++)
+		{
+			if (pOrphan->_head[slot] != nullptr && pEpochManager->IsSafe(pOrphan->_epoch[slot]))
+				Reclaim(pOrphan, slot);
+		}
+
+		if (pOrphan->_count == 0)
+			_retireListManager->Free(pOrphan);
+		else
+			PushOrphan(pOrphan);
+	}
+}
+
+template <class T, size_t ChunkSize>
+void MemoryPoolTLS<T, ChunkSize>::ReleaseTlsChunk(void* pOwner, void* pCache)
+{
+	MemoryPoolTLS* pPool = reinterpret_cast<MemoryPoolTLS*>(pOwner);
+	Chunk* pChunk = reinterpret_cast<Chunk*>(pCache);
+
+	//  ִٸ   ʾҴ FreeStack ȯ(Alloc Ϻθ  Chunk ó)
+	if (pChunk->isEmpty())
+		pPool->_emptyChunkManager->Free(pChunk);
+	else
+		pPool->ChunkFree(pChunk);
+}
+
+template <class T, size_t ChunkSize>
+void MemoryPoolTLS<T, ChunkSize>::ReleaseRetireList(void* pOwner, void* pCache)
+{
+	MemoryPoolTLS* pPool = reinterpret_cast<MemoryPoolTLS*>(pOwner);
+	RETIRE_LIST* pList = reinterpret_cast<RETIRE_LIST*>(pCache);
+
+	//    Chunk ĳô ̹ ݳǾ  Ƿ ⼭ ȸ ʰ ѱ
+	if (pList->_count == 0)
+		pPool->_retireListManager->Free(pList);
+	else
+		pPool->PushOrphan(pList);
+}
+
+template <class T, size_t ChunkSize>
+void MemoryPoolTLS<T, ChunkSize>::BlockFree(BLOCK* pBlock)
+{
+	Chunk* pTlsChunk = reinterpret_cast<Chunk*>(PoolRegistry::GetCache(_chunkKey));
 	if (pTlsChunk == nullptr)
 	{
 		//   Chunk Ҵ
 		pTlsChunk = _emptyChunkManager->Alloc();
-		TlsSetValue(_tlsIdx, pTlsChunk);
+		PoolRegistry::SetCache(_chunkKey, pTlsChunk);
 	}
 
-	if(!pTlsChunk->Push(pushNode))
+	if(!pTlsChunk->Push(pBlock))
 	{
 		ChunkFree(pTlsChunk);
 		pTlsChunk = _emptyChunkManager->Alloc();
-		pTlsChunk->Push(pushNode);
-		TlsSetValue(_tlsIdx, pTlsChunk);
+		pTlsChunk->Push(pBlock);
+		PoolRegistry::SetCache(_chunkKey, pTlsChunk);
 	}
-	return true;
+
+	//   尡 ִٸ   ʾҴ Chunk Ѱ
+	// Ȯ   Ǯ̸   Chunk  Free   ʰ ٷ Ѱ
+	if (_waiterCnt > 0 || (pTlsChunk->isFull() && IsExhausted()))
+	{
+		ChunkFree(pTlsChunk);
+		PoolRegistry::SetCache(_chunkKey, nullptr);
+	}
+}
+
+template <class T, size_t ChunkSize>
+void MemoryPoolTLS<T, ChunkSize>::Reclaim(RETIRE_LIST* pList, UINT64 slot)
+{
+	BLOCK* pBlock = pList->_head[slot];
+	BLOCK* pNext;
+	while (pBlock != nullptr)
+	{
+		pNext = pBlock->_next;
+		if (_isPlacementNew)
+			pBlock->_data.~T();
+		BlockFree(pBlock);
+		--pList->_count;
+		pBlock = pNext;
+	}
+	pList->_head[slot] = nullptr;
 }
 
 
@@ -342,6 +660,10 @@ void MemoryPoolTLS<T, ChunkSize>::ChunkFree(Chunk* pChunk)
 #ifndef MEMORYPOOL_MODE_RELEASE
 	InterlockedDecrement64((PLONG64)&_useChunk);
 #endif // !MEMORYPOOL_MODE_RELEASE
+
+	// ڰ  ý ȣ 
+	if (_waiterCnt > 0)
+		WakeByAddressAll((PVOID)&_freeStackTop);
 }
 
 template <class T, size_t ChunkSize>
@@ -354,8 +676,14 @@ void MemoryPoolTLS<T, ChunkSize>::Push(Chunk* pChunk)
 		bkTop = _freeStackTop;
 		idx = (UINT64)bkTop >> 47;
 		pChunk->_next = (Chunk*)((UINT64)bkTop & 0x00007FFFFFFFFFFF);
+#ifdef MEMORYPOOL_COUNT_CAS
+		InterlockedIncrement64((PLONG64)&_casCnt);
+#endif // MEMORYPOOL_COUNT_CAS
 		if (InterlockedCompareExchange64((PLONG64)&_freeStackTop, (LONG64)pChunk | ((UINT64)idx << 47), (LONG64)bkTop) == (LONG64)bkTop)
 			break;
+#ifdef MEMORYPOOL_COUNT_CAS
+		InterlockedIncrement64((PLONG64)&_casFailCnt);
+#endif // MEMORYPOOL_COUNT_CAS
 	}
 }
 
@@ -376,13 +704,58 @@ bool MemoryPoolTLS<T, ChunkSize>::Pop(Chunk** pDestChunk)
 
 		nextTop = popNode->_next;
 
+#ifdef MEMORYPOOL_COUNT_CAS
+		InterlockedIncrement64((PLONG64)&_casCnt);
+#endif // MEMORYPOOL_COUNT_CAS
 		if (InterlockedCompareExchange64((PLONG64)&_freeStackTop, (LONG64)nextTop | ((UINT64)idx << 47), (LONG64)bkTop) == (LONG64)bkTop)
 			break;
+#ifdef MEMORYPOOL_COUNT_CAS
+		InterlockedIncrement64((PLONG64)&_casFailCnt);
+#endif // MEMORYPOOL_COUNT_CAS
 	}
 	*pDestChunk = popNode;
 
 	return true;
 }
+template <class T, size_t ChunkSize>
+void MemoryPoolTLS<T, ChunkSize>::PushOrphan(RETIRE_LIST* pList)
+{
+	volatile UINT64 idx;
+	volatile RETIRE_LIST* bkTop;
+	while (1)
+	{
+		bkTop = _orphanTop;
+		idx = (UINT64)bkTop >> 47;
+		pList->_next = (RETIRE_LIST*)((UINT64)bkTop & 0x00007FFFFFFFFFFF);
+		if (InterlockedCompareExchange64((PLONG64)&_orphanTop, (LONG64)pList | ((UINT64)idx << 47), (LONG64)bkTop) == (LONG64)bkTop)
+			break;
+	}
+}
+
+template <class T, size_t ChunkSize>
+bool MemoryPoolTLS<T, ChunkSize>::PopOrphan(RETIRE_LIST** pDestList)
+{
+	volatile void* bkTop;
+	volatile UINT64 idx;
+	RETIRE_LIST* popNode;
+	volatile RETIRE_LIST* nextTop;
+	while (1)
+	{
+		bkTop = _orphanTop;
+		idx = ((UINT64)bkTop >> 47) + 1;
+		popNode = (RETIRE_LIST*)((UINT64)bkTop & 0x00007FFFFFFFFFFF);
+		if (popNode == nullptr)
+			return false;
+
+		nextTop = popNode->_next;
+
+		if (InterlockedCompareExchange64((PLONG64)&_orphanTop, (LONG64)nextTop | ((UINT64)idx << 47), (LONG64)bkTop) == (LONG64)bkTop)
+			break;
+	}
+	*pDestList = popNode;
+
+	return true;
+}
 ///////////////////////////////////////////////////////////////////////////////////////
 /* Chunk Class */
 template <class T, size_t ChunkSize>
@@ -0,0 +1,194 @@
+#pragma once
+#include <Windows.h>
+#include <cstring>
+
+/*
+# 庰 Ǯ ĳ ̺(PoolRegistry)
+
+Ǯ TlsAlloc  ϳ       ID ߱޹ް
+  thread_local ̺ ID ٷ ĳ(TLS Chunk ) ãϴ.
+
+- Ű ( << 32) | ID ̸ Ǯ ҸǸ 밡 ϹǷ
+   ID ִ  Ǯ ĳô õ
+-    ִ Ǯ ĳô ϵ ݳ Լ Ǯ 
+  ݳ ۵ (ٸ thread_local Ҹ ) SetCache   Ƿ õǸ
+   忡 Ǯ   Chunk Ǯ Ҹ  ƿ 
+*/
+
+#define POOL_REGISTRY_INIT_SLOT		64
+
+typedef UINT64 poolkey_t;
+typedef void (*POOL_CACHE_RELEASE)(void* pOwner, void* pCache);
+
+class PoolRegistry
+{
+private:
+	struct SLOT
+	{
+		void*				_owner;
+		POOL_CACHE_RELEASE	_release;
+		UINT32				_gen;
+		UINT32				_nextFree;
+	};
+	struct REGISTRY
+	{
+		REGISTRY() :_slots(nullptr), _slotCnt(0), _capacity(0), _freeHead(UINT32_MAX) { InitializeSRWLock(&_lock); }
+		~REGISTRY() { delete[] _slots; }
+		SRWLOCK	_lock;
+		SLOT*	_slots;
+		UINT32	_slotCnt;
+		UINT32	_capacity;
+		UINT32	_freeHead;
+	};
+	struct ENTRY
+	{
+		void*	_cache;
+		UINT32	_gen;
+	};
+	// thread_local ʱȭ ˻簡  POD 
+	struct TABLE
+	{
+		ENTRY*	_entries;
+		UINT32	_capacity;
+		bool	_isReleased;	// ReleaseThread   ̺ ٽ  
+	};
+	//    ĳ ݳ
+	struct EXIT_HOOK
+	{
+		~EXIT_HOOK() { ReleaseThread(); }
+	};
+public:
+	static poolkey_t Acquire(void* pOwner, POOL_CACHE_RELEASE release);
+	static void Release(poolkey_t key);
+
+	static void* GetCache(poolkey_t key)
+	{
+		TABLE& table = GetTable();
+		UINT32 id = (UINT32)key;
+		if (id < table._capacity && table._entries[id]._gen == (UINT32)(key >> 32))
+			return table._entries[id]._cache;
+		return nullptr;
+	}
+	static void SetCache(poolkey_t key, void* pCache)
+	{
+		TABLE& table = GetTable();
+		if (table._isReleased)
+			return;
+		UINT32 id = (UINT32)key;
+		if (id >= table._capacity)
+			Grow(id);
+		table._entries[id]._cache = pCache;
+		table._entries[id]._gen = (UINT32)(key >> 32);
+	}
+private:
+	static TABLE& GetTable()
+	{
+		static thread_local TABLE table;
+		return table;
+	}
+	static REGISTRY& GetRegistry()
+	{
+		static REGISTRY registry;
+		return registry;
+	}
+	static void Grow(UINT32 id);
+	static void ReleaseThread();
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+inline poolkey_t PoolRegistry::Acquire(void* pOwner, POOL_CACHE_RELEASE release)
+{
+	REGISTRY& registry = GetRegistry();
+	UINT32 id;
+
+	AcquireSRWLockExclusive(&registry._lock);
+	if (registry._freeHead != UINT32_MAX)
+	{
+		// Ҹ Ǯ ID 
+		id = registry._freeHead;
+		registry._freeHead = registry._slots[id]._nextFree;
+	}
+	else
+	{
+		if (registry._slotCnt == registry._capacity)
+		{
+			UINT32 newCapacity = registry._capacity == 0 ? POOL_REGISTRY_INIT_SLOT : registry._capacity * 2;
+			SLOT* pNewSlots = new SLOT[newCapacity];
+			if (registry._slots != nullptr)
+				memcpy(pNewSlots, registry._slots, sizeof(SLOT) * registry._slotCnt);
+			delete[] registry._slots;
+			registry._slots = pNewSlots;
+			registry._capacity = newCapacity;
+		}
+		id = registry._slotCnt++;
+		registry._slots[id]._gen = 1;	//  0  ׸ ϱ   
+	}
+	registry._slots[id]._owner = pOwner;
+	registry._slots[id]._release = release;
+	registry._slots[id]._nextFree = UINT32_MAX;
+	poolkey_t key = ((poolkey_t)registry._slots[id]._gen << 32) | id;
+	ReleaseSRWLockExclusive(&registry._lock);
+
+	return key;
+}
+
+inline void PoolRegistry::Release(poolkey_t key)
+{
+	REGISTRY& registry = GetRegistry();
+	UINT32 id = (UINT32)key;
+
+	AcquireSRWLockExclusive(&registry._lock);
+	// 븦 ÷ ٸ  ̺  ĳ ȿȭ
+	if (++registry._slots[id]._gen == 0)
+		registry._slots[id]._gen = 1;
+	registry._slots[id]._owner = nullptr;
+	registry._slots[id]._release = nullptr;
+	registry._slots[id]._nextFree = registry._freeHead;
+	registry._freeHead = id;
+	ReleaseSRWLockExclusive(&registry._lock);
+}
+
+inline void PoolRegistry::Grow(UINT32 id)
+{
+	TABLE& table = GetTable();
+	if (table._capacity == 0)
+	{
+		// ó ĳø ϴ 常   
+		static thread_local EXIT_HOOK hook;
+		(void)hook;
+	}
+
+	UINT32 newCapacity = table._capacity == 0 ? POOL_REGISTRY_INIT_SLOT : table._capacity;
+	while (newCapacity <= id)
+		newCapacity *= 2;
+
+	ENTRY* pNewEntries = new ENTRY[newCapacity]();
+	if (table._entries != nullptr)
+		memcpy(pNewEntries, table._entries, sizeof(ENTRY) * table._capacity);
+	delete[] table._entries;
+	table._entries = pNewEntries;
+	table._capacity = newCapacity;
+}
+
+inline void PoolRegistry::ReleaseThread()
+{
+	TABLE& table = GetTable();
+	REGISTRY& registry = GetRegistry();
+	table._isReleased = true;
+
+	// ݳ  Ǯ Ҹ ʵ  
+	AcquireSRWLockShared(&registry._lock);
+	for (UINT32 id = 0; id < table._capacity; id++)
+	{
+		ENTRY& entry = table._entries[id];
+		if (entry._cache == nullptr || id >= registry._slotCnt || registry._slots[id]._gen != entry._gen)
+			continue;
+		registry._slots[id]._release(registry._slots[id]._owner, entry._cache);
+		entry._cache = nullptr;
+	}
+	ReleaseSRWLockShared(&registry._lock);
+
+	delete[] table._entries;
+	table._entries = nullptr;
+	table._capacity = 0;
+}
@@ -0,0 +1,604 @@
+#pragma once
+#include "MemoryPoolTLS.h"
+#define SHARED_POOL_MAGIC			0x4C4F4F504D4853ULL	// "SHMPOOL"
+#define SHARED_POOL_VERSION			3
+#define SHARED_POOL_STATE_INIT		0
+#define SHARED_POOL_STATE_READY		1
+#define SHARED_POOL_ATTACH_TIMEOUT	10000	// ٸ μ ʱȭ (ms)
+#define SHARED_POOL_ALIGN			64
+
+/*
+#  ޸ /   ޸Ǯ(SharedMemoryPool)
+
+  Chunk  ̸ ִ  ޸ Ǵ ޸  Ͽ δ ǮԴϴ.
+μ  ּҰ ٸǷ  ũ   ּ  offset̸
+offset  47bit ̳̹Ƿ  17bit ± CAS ״ մϴ.
+
+SharedMemoryPool<T> pool(L"Local\\MyPool", L"pool.bin", blockNum, maxThreadNum, false);
+
+- name  : ¡  ,  ̸  μ 
+- fileName  :  ȿϸ  ȣ(isPlacementNew == false ʱȭ)  ٷ 
+                   μ   Բ  name ؾ 
+                  name     Ƿ    ٸ μ   
+- 尡 ĳ  Chunk   CHUNK ( Ǯ ü) ȣ 
+  Ǯ Ҹ  ִ ٸ 尡 ĳ  Chunk  ȣ ã ݳ
+-  ڰ  ߴٸ ó  μ ڰ  Chunk ã ݳ
+  (Ҵ  ϰ Ʈ ״ ,   ű Chunk    ǵ  )
+- T   μ    ʾƾ 
+  ٸ  ų  GetOffset  offset ϰ OffsetToObject ǵ
+-   ڷᱸ ٽ ã  ֵ  Ʈ offset ϳ (SetRoot/GetRoot)
+- Ȯ Ҵ   maxThreadNum ÿ Chunk ĳϴ   
+*/
+
+template <class T, size_t ChunkSize = NUM_OF_BLOCK_IN_CHUNK>
+class SharedMemoryPool
+{
+private:
+	struct BLOCK
+	{
+#ifndef MEMORYPOOL_MODE_RELEASE
+		code_t	_preCode;
+#endif // !MEMORYPOOL_MODE_RELEASE
+		T		_data;
+		UINT64	_next;		// offset
+#ifndef MEMORYPOOL_MODE_RELEASE
+		code_t	_postCode;
+#endif // !MEMORYPOOL_MODE_RELEASE
+	};
+
+	//  offset ChunkSize  Chunk,   ġ
+	struct CHUNK
+	{
+		volatile UINT64	_next;			// offset
+		UINT64			_freeStackTop;	//  offset
+		UINT64			_size;
+		volatile LONG	_ownerId;		// ĳ  Ǯ ü ȣ, ÿ  0
+	};
+
+	//    տ ġϴ  
+	struct alignas(SHARED_POOL_ALIGN) HEADER
+	{
+		UINT64			_magic;
+		UINT32			_version;
+		UINT32			_blockSize;
+		UINT64			_chunkSize;
+		UINT64			_blockNum;
+		UINT64			_chunkNum;
+		UINT64			_chunkOffset;
+		UINT64			_blockOffset;
+		code_t			_poolCode;
+		volatile LONG	_state;
+		volatile LONG	_attachCnt;		//  и  , 0 ƴϸ   Ǵ
+		volatile UINT64	_rootOffset;	//  Ʈ ü offset
+		volatile LONG	_ownerSeq;		// ϴ Ǯ ü  ȣ ߱
+
+		// ± offset 
+		alignas(SHARED_POOL_ALIGN) volatile UINT64	_freeStackTop;		//   Chunk
+		alignas(SHARED_POOL_ALIGN) volatile UINT64	_emptyStackTop;		//  Chunk
+		alignas(SHARED_POOL_ALIGN) volatile UINT64	_orphanBlockTop;	// Chunk   
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////
+public:
+	SharedMemoryPool() = delete;
+	template <typename... Types>
+	SharedMemoryPool(const WCHAR* name, const WCHAR* fileName, UINT64 blockNum, UINT32 maxThreadNum, bool isPlacementNew, Types... args);
+	~SharedMemoryPool();
+	template <typename... Types>
+	T* Alloc(Types... args);
+	bool Free(T* data);
+	bool IsWarmStarted() { return _isWarmStarted; }
+
+	// μ  ּҰ ٸǷ   ȿ offset ü Ŵ(0 nullptr)
+	UINT64 GetOffset(T* data) { return ToOffset(data); }
+	T* OffsetToObject(UINT64 offset) { return ToPtr<T>(offset); }
+	void SetRoot(UINT64 offset) { InterlockedExchange64((PLONG64)&_header->_rootOffset, (LONG64)offset); }
+	UINT64 GetRoot() { return _header->_rootOffset; }
+private:
+	template <typename... Types>
+	const WCHAR* Open(const WCHAR* name, const WCHAR* fileName, UINT64 blockNum, UINT32 maxThreadNum, Types... args);
+	void Close();
+	void Relink();
+	void RecoverChunks(LONG ownerId);	// ownerId ĳ ̴ Chunk ݳ, 0̸  
+	void CacheChunk(CHUNK* pChunk);
+	void ReturnChunk(CHUNK* pChunk);	//   , Chunk   ȯ
+	bool ChunkPush(CHUNK* pChunk, BLOCK* pBlock);
+	bool ChunkPop(CHUNK* pChunk, BLOCK** pDestBlock);
+	// ± offset 
+	void Push(volatile UINT64* pTop, UINT64 offset, volatile UINT64* pNext);
+	bool PopChunk(volatile UINT64* pTop, CHUNK** pDestChunk);
+	bool PopBlock(volatile UINT64* pTop, BLOCK** pDestBlock);
+	void PushChunk(volatile UINT64* pTop, CHUNK* pChunk) { Push(pTop, ToOffset(pChunk), &pChunk->_next); }
+	void PushBlock(BLOCK* pBlock) { Push(&_header->_orphanBlockTop, ToOffset(pBlock), (volatile UINT64*)&pBlock->_next); }
+	//    PoolRegistry ȣ
+	static void ReleaseTlsChunk(void* pOwner, void* pCache);
+
+	UINT64 ToOffset(void* ptr) { return ptr == nullptr ? 0 : (UINT64)((char*)ptr - _base); }
+	template <class P>
+	P* ToPtr(UINT64 offset) { return offset == 0 ? nullptr : reinterpret_cast<P*>(_base + offset); }
+private:
+	// Mapping
+	HANDLE		_file;
+	HANDLE		_mapping;
+	char*		_base;
+	HEADER*		_header;
+	CHUNK*		_chunkArray;
+	BLOCK*		_blockArray;
+	bool		_isWarmStarted;
+
+	//  Ǯ ü Chunk  ȣ
+	LONG		_ownerId;
+
+	// Setting
+	const bool		_isPlacementNew;
+
+	//	COMMON, PoolRegistry Ű
+	poolkey_t		_chunkKey;
+
+#ifndef MEMORYPOOL_MODE_RELEASE
+	// Debugging
+	code_t			_myCode;
+#endif // !MEMORYPOOL_MODE_RELEASE
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+template <class T, size_t ChunkSize>
+template <typename... Types>
+SharedMemoryPool<T, ChunkSize>::SharedMemoryPool(const WCHAR* name, const WCHAR* fileName, UINT64 blockNum, UINT32 maxThreadNum, bool isPlacementNew, Types... args)
+	:_file(INVALID_HANDLE_VALUE), _mapping(NULL), _base(nullptr), _isWarmStarted(false), _ownerId(0), _isPlacementNew(isPlacementNew)
+{
+	if (blockNum == 0 || maxThreadNum == 0 || (name == nullptr && fileName == nullptr))
+		throw L"Error: Parameter is not correct.";
+
+	// ̸ ִٸ /ʱȭ ٸ μ  ġ ʵ ̸ ִ ؽ ȣ
+	HANDLE initLock = NULL;
+	if (name != nullptr)
+	{
+		WCHAR lockName[MAX_PATH];
+		if (wcscpy_s(lockName, name) != 0 || wcscat_s(lockName, L"_InitLock") != 0)
+			throw L"Error: Parameter is not correct.";
+		initLock = CreateMutexW(NULL, FALSE, lockName);
+		if (initLock == NULL)
+			throw GetLastError();
+		if (WaitForSingleObject(initLock, SHARED_POOL_ATTACH_TIMEOUT) == WAIT_TIMEOUT)
+		{
+			CloseHandle(initLock);
+			throw L"Error: Shared pool is not initialized.";
+		}
+	}
+
+	const WCHAR* pError = Open(name, fileName, blockNum, maxThreadNum, args...);
+
+	if (initLock != NULL)
+	{
+		ReleaseMutex(initLock);
+		CloseHandle(initLock);
+	}
+	if (pError != nullptr)
+		throw pError;
+
+	_chunkKey = PoolRegistry::Acquire(this, ReleaseTlsChunk);
+}
+
+template <class T, size_t ChunkSize>
+template <typename... Types>
+const WCHAR* SharedMemoryPool<T, ChunkSize>::Open(const WCHAR* name, const WCHAR* fileName, UINT64 blockNum, UINT32 maxThreadNum, Types... args)
+{
+	//   ġ , [HEADER][CHUNK * chunkNum][BLOCK * blockNum]
+	UINT64 blockChunkCnt = (blockNum + (ChunkSize - 1)) / ChunkSize;
+	UINT64 chunkNum = blockChunkCnt + maxThreadNum + 1;
+	UINT64 chunkOffset = sizeof(HEADER);
+	UINT64 blockOffset = chunkOffset + sizeof(CHUNK) * chunkNum;
+	blockOffset = (blockOffset + (SHARED_POOL_ALIGN - 1)) / SHARED_POOL_ALIGN * SHARED_POOL_ALIGN;
+	UINT64 mapSize = blockOffset + sizeof(BLOCK) * blockNum;
+	if (alignof(BLOCK) > SHARED_POOL_ALIGN || mapSize > 0x00007FFFFFFFFFFF)
+		return L"Error: Parameter is not correct.";
+
+	bool isFileExist = false;
+	if (fileName != nullptr)
+	{
+		// ̸   ٸ μ ã  Ƿ,       ٽ (Relink) ʵ  
+		DWORD shareMode = name != nullptr ? FILE_SHARE_READ | FILE_SHARE_WRITE : 0;
+		_file = CreateFileW(fileName, GENERIC_READ | GENERIC_WRITE, shareMode, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (_file == INVALID_HANDLE_VALUE)
+		{
+			if (GetLastError() == ERROR_SHARING_VIOLATION)
+				return L"Error: Pool file is in use by another process.";
+			return L"Error: Failed to open pool file.";
+		}
+		isFileExist = GetLastError() == ERROR_ALREADY_EXISTS;
+	}
+
+	_mapping = CreateFileMappingW(_file, NULL, PAGE_READWRITE, (DWORD)(mapSize >> 32), (DWORD)mapSize, name);
+	if (_mapping == NULL)
+	{
+		Close();
+		return L"Error: Failed to create file mapping.";
+	}
+	// ٸ μ ̹   
+	bool isMappingExist = GetLastError() == ERROR_ALREADY_EXISTS;
+
+	_base = reinterpret_cast<char*>(MapViewOfFile(_mapping, FILE_MAP_ALL_ACCESS, 0, 0, (SIZE_T)mapSize));
+	if (_base == nullptr)
+	{
+		Close();
+		return L"Error: Failed to map view of file.";
+	}
+	_header = reinterpret_cast<HEADER*>(_base);
+	_chunkArray = reinterpret_cast<CHUNK*>(_base + chunkOffset);
+	_blockArray = reinterpret_cast<BLOCK*>(_base + blockOffset);
+
+	if (isMappingExist)
+	{
+		if (_header->_state != SHARED_POOL_STATE_READY)
+		{
+			Close();
+			return L"Error: Shared pool is not initialized.";
+		}
+		_isWarmStarted = true;
+	}
+	else if (isFileExist && _header->_magic == SHARED_POOL_MAGIC && _header->_state == SHARED_POOL_STATE_READY)
+	{
+		//     
+		_isWarmStarted = true;
+	}
+
+	if (_isWarmStarted)
+	{
+		if (_header->_version != SHARED_POOL_VERSION || _header->_blockSize != sizeof(BLOCK)
+			|| _header->_chunkSize != ChunkSize || _header->_blockNum != blockNum
+			|| _header->_chunkNum != chunkNum || _header->_blockOffset != blockOffset)
+		{
+			Close();
+			return L"Error: Shared pool layout does not match.";
+		}
+	}
+	else
+	{
+		_header->_state = SHARED_POOL_STATE_INIT;
+		_header->_magic = SHARED_POOL_MAGIC;
+		_header->_version = SHARED_POOL_VERSION;
+		_header->_blockSize = sizeof(BLOCK);
+		_header->_chunkSize = ChunkSize;
+		_header->_blockNum = blockNum;
+		_header->_chunkNum = chunkNum;
+		_header->_chunkOffset = chunkOffset;
+		_header->_blockOffset = blockOffset;
+		_header->_poolCode = (GetTickCount64() << 32) ^ GetCurrentProcessId() ^ (UINT64)_base;
+		_header->_attachCnt = 0;
+		_header->_rootOffset = 0;
+		_header->_ownerSeq = 0;
+	}
+
+#ifndef MEMORYPOOL_MODE_RELEASE
+	_myCode = _header->_poolCode;
+#endif // !MEMORYPOOL_MODE_RELEASE
+
+	if (!_isWarmStarted)
+	{
+		Relink();
+		if (!_isPlacementNew)
+		{
+			for (UINT64 i = 0; i < blockNum; i++)
+				new (&_blockArray[i]._data) T(args...);
+		}
+		_header->_state = SHARED_POOL_STATE_READY;
+	}
+	else if (!isMappingExist && _header->_attachCnt != 0)
+	{
+		//  ڰ  Ͽ  ĳø ݳ Ƿ ڰ  Chunk ݳ
+		RecoverChunks(0);
+	}
+
+	if (!isMappingExist)
+		_header->_attachCnt = 0;
+	InterlockedIncrement(&_header->_attachCnt);
+
+	// 0   ϹǷ ǳʶ
+	do
+	{
+		_ownerId = InterlockedIncrement(&_header->_ownerSeq);
+	} while (_ownerId == 0);
+	return nullptr;
+}
+
+template <class T, size_t ChunkSize>
+void SharedMemoryPool<T, ChunkSize>::Close()
+{
+	if (_base != nullptr)
+		UnmapViewOfFile(_base);
+	if (_mapping != NULL)
+		CloseHandle(_mapping);
+	if (_file != INVALID_HANDLE_VALUE)
+		CloseHandle(_file);
+	_base = nullptr;
+	_mapping = NULL;
+	_file = INVALID_HANDLE_VALUE;
+}
+
+template <class T, size_t ChunkSize>
+SharedMemoryPool<T, ChunkSize>::~SharedMemoryPool()
+{
+	//   ĳ ݳ
+	CHUNK* pTlsChunk = reinterpret_cast<CHUNK*>(PoolRegistry::GetCache(_chunkKey));
+	if (pTlsChunk != nullptr)
+	{
+		ReleaseTlsChunk(this, pTlsChunk);
+		PoolRegistry::SetCache(_chunkKey, nullptr);
+	}
+	PoolRegistry::Release(_chunkKey);
+
+	//  ִ ٸ 尡 ĳ  Chunk ݳ, Ҹ Ŀ  Ǯ  Ƿ 
+	RecoverChunks(_ownerId);
+	InterlockedDecrement(&_header->_attachCnt);
+
+	Close();
+}
+
+template <class T, size_t ChunkSize>
+template <typename... Types>
+T* SharedMemoryPool<T, ChunkSize>::Alloc(Types... args)
+{
+	BLOCK* pPopedBlock = nullptr;
+
+	CHUNK* pTlsChunk = reinterpret_cast<CHUNK*>(PoolRegistry::GetCache(_chunkKey));
+	if (pTlsChunk == nullptr || !ChunkPop(pTlsChunk, &pPopedBlock))
+	{
+		//   Chunk ȯ
+		if (pTlsChunk != nullptr)
+		{
+			PoolRegistry::SetCache(_chunkKey, nullptr);
+			ReturnChunk(pTlsChunk);
+		}
+
+		//   Chunk Ҵ,  Chunk    
+		if (PopChunk(&_header->_freeStackTop, &pTlsChunk))
+		{
+			CacheChunk(pTlsChunk);
+			ChunkPop(pTlsChunk, &pPopedBlock);
+		}
+		else if (!PopBlock(&_header->_orphanBlockTop, &pPopedBlock))
+		{
+			return nullptr;
+		}
+	}
+
+#ifndef MEMORYPOOL_MODE_RELEASE
+	// Ҵ ޸ п ڵ ȯ
+	pPopedBlock->_postCode = ~pPopedBlock->_postCode;
+#endif // !MEMORYPOOL_MODE_RELEASE
+
+	if (_isPlacementNew)
+		return new (&pPopedBlock->_data) T(args...);
+	else
+		return &pPopedBlock->_data;
+}
+
+template <class T, size_t ChunkSize>
+bool SharedMemoryPool<T, ChunkSize>::Free(T* data)
+{
+	BLOCK* pushNode = reinterpret_cast<BLOCK*>(
+		reinterpret_cast<__int64>(data) - reinterpret_cast<__int64>(&((BLOCK*)0)->_data)
+		);
+
+	//    ּ ˻
+	if (pushNode < _blockArray || pushNode >= _blockArray + _header->_blockNum)
+		return false;
+
+#ifndef MEMORYPOOL_MODE_RELEASE
+	// ޸ ħ  ȿ ˻(Ҵ  ޸ ľ)
+	if (pushNode->_preCode != pushNode->_postCode)
+		return false;
+
+	// ٸ ޸Ǯ ȯϷϴ  ˻
+	if (pushNode->_preCode != _myCode)
+		return false;
+
+	//  ޸ п ڵ ȯ
+	pushNode->_postCode = ~pushNode->_postCode;
+#endif // !MEMORYPOOL_MODE_RELEASE
+
+	// Ҹ ȣ  
+	if (_isPlacementNew)
+		data->~T();
+
+	CHUNK* pTlsChunk = reinterpret_cast<CHUNK*>(PoolRegistry::GetCache(_chunkKey));
+	if (pTlsChunk == nullptr)
+	{
+		//  Chunk  ϸ Chunk  ϸ ȯ
+		if (!PopChunk(&_header->_emptyStackTop, &pTlsChunk))
+		{
+			PushBlock(pushNode);
+			return true;
+		}
+		CacheChunk(pTlsChunk);
+	}
+
+	// ĳ  Chunk    ѱǷ ׻  ڸ 
+	ChunkPush(pTlsChunk, pushNode);
+
+	//   Chunk  Free ٸ ʰ ٷ ٸ /μ   ֵ ѱ
+	if (pTlsChunk->_size == ChunkSize)
+	{
+		PoolRegistry::SetCache(_chunkKey, nullptr);
+		pTlsChunk->_ownerId = 0;
+		PushChunk(&_header->_freeStackTop, pTlsChunk);
+	}
+	return true;
+}
+
+template <class T, size_t ChunkSize>
+void SharedMemoryPool<T, ChunkSize>::Relink()
+{
+	_header->_freeStackTop = 0;
+	_header->_emptyStackTop = 0;
+	_header->_orphanBlockTop = 0;
+
+	UINT64 blockNum = _header->_blockNum;
+	UINT64 blockChunkCnt = (blockNum + (ChunkSize - 1)) / ChunkSize;
+	CHUNK* pChunk;
+	for (UINT64 i = 0; i < _header->_chunkNum; i++)
+	{
+		pChunk = &_chunkArray[i];
+		pChunk->_freeStackTop = 0;
+		pChunk->_size = 0;
+		pChunk->_ownerId = 0;
+		if (i >= blockChunkCnt)
+		{
+			PushChunk(&_header->_emptyStackTop, pChunk);
+			continue;
+		}
+
+		UINT64 edIdx = ChunkSize * (i + 1) < blockNum ? ChunkSize * (i + 1) : blockNum;
+		for (UINT64 j = ChunkSize * i; j < edIdx; j++)
+		{
+#ifndef MEMORYPOOL_MODE_RELEASE
+			_blockArray[j]._preCode = _myCode;
+			_blockArray[j]._postCode = ~_myCode;
+#endif // !MEMORYPOOL_MODE_RELEASE
+			ChunkPush(pChunk, &_blockArray[j]);
+		}
+		PushChunk(&_header->_freeStackTop, pChunk);
+	}
+}
+
+template <class T, size_t ChunkSize>
+void SharedMemoryPool<T, ChunkSize>::ReleaseTlsChunk(void* pOwner, void* pCache)
+{
+	SharedMemoryPool* pPool = reinterpret_cast<SharedMemoryPool*>(pOwner);
+	CHUNK* pChunk = reinterpret_cast<CHUNK*>(pCache);
+
+	//   Chunk Free ٷ ѱǷ ĳ  Chunk ׻ Ϻθ  
+	pPool->ReturnChunk(pChunk);
+}
+
+template <class T, size_t ChunkSize>
+void SharedMemoryPool<T, ChunkSize>::RecoverChunks(LONG ownerId)
+{
+	CHUNK* pChunk;
+	for (UINT64 i = 0; i < _header->_chunkNum; i++)
+	{
+		pChunk = &_chunkArray[i];
+		if (pChunk->_ownerId == 0 || (ownerId != 0 && pChunk->_ownerId != ownerId))
+			continue;
+
+		//   ChunkPush/ChunkPop ߰   Ƿ     
+		UINT64 size = 0;
+		UINT64 offset = pChunk->_freeStackTop;
+		while (offset != 0 && size < ChunkSize)
+		{
+			offset = ToPtr<BLOCK>(offset)->_next;
+			++size;
+		}
+		pChunk->_size = size;
+		ReturnChunk(pChunk);
+	}
+}
+
+template <class T, size_t ChunkSize>
+void SharedMemoryPool<T, ChunkSize>::CacheChunk(CHUNK* pChunk)
+{
+	// ĳÿ ֱ  ڸ    ÿ ã  ֵ 
+	pChunk->_ownerId = _ownerId;
+	PoolRegistry::SetCache(_chunkKey, pChunk);
+}
+
+template <class T, size_t ChunkSize>
+void SharedMemoryPool<T, ChunkSize>::ReturnChunk(CHUNK* pChunk)
+{
+	// Ϻθ  Chunk ׿  Chunk ڶ ʵ   ȯ
+	BLOCK* pBlock;
+	while (ChunkPop(pChunk, &pBlock))
+		PushBlock(pBlock);
+
+	// ÿ ֱ  ڸ      Chunk    ʵ 
+	pChunk->_ownerId = 0;
+	PushChunk(&_header->_emptyStackTop, pChunk);
+}
+
+template <class T, size_t ChunkSize>
+bool SharedMemoryPool<T, ChunkSize>::ChunkPush(CHUNK* pChunk, BLOCK* pBlock)
+{
+	if (pChunk->_size == ChunkSize)
+		return false;
+	pBlock->_next = pChunk->_freeStackTop;
+	pChunk->_freeStackTop = ToOffset(pBlock);
+	++pChunk->_size;
+	return true;
+}
+
+template <class T, size_t ChunkSize>
+bool SharedMemoryPool<T, ChunkSize>::ChunkPop(CHUNK* pChunk, BLOCK** pDestBlock)
+{
+	if (pChunk->_size == 0)
+		return false;
+	*pDestBlock = ToPtr<BLOCK>(pChunk->_freeStackTop);
+	pChunk->_freeStackTop = (*pDestBlock)->_next;
+	--pChunk->_size;
+	return true;
+}
+
+template <class T, size_t ChunkSize>
+void SharedMemoryPool<T, ChunkSize>::Push(volatile UINT64* pTop, UINT64 offset, volatile UINT64* pNext)
+{
+	volatile UINT64 idx;
+	UINT64 bkTop;
+	while (1)
+	{
+		bkTop = *pTop;
+		idx = bkTop >> 47;
+		*pNext = bkTop & 0x00007FFFFFFFFFFF;
+		if (InterlockedCompareExchange64((PLONG64)pTop, (LONG64)(offset | (idx << 47)), (LONG64)bkTop) == (LONG64)bkTop)
+			break;
+	}
+}
+
+template <class T, size_t ChunkSize>
+bool SharedMemoryPool<T, ChunkSize>::PopChunk(volatile UINT64* pTop, CHUNK** pDestChunk)
+{
+	UINT64 bkTop;
+	volatile UINT64 idx;
+	CHUNK* popNode;
+	UINT64 nextTop;
+	while (1)
+	{
+		bkTop = *pTop;
+		idx = (bkTop >> 47) + 1;
+		popNode = ToPtr<CHUNK>(bkTop & 0x00007FFFFFFFFFFF);
+		if (popNode == nullptr)
+			return false;
+
+		nextTop = popNode->_next;
+
+		if (InterlockedCompareExchange64((PLONG64)pTop, (LONG64)(nextTop | (idx << 47)), (LONG64)bkTop) == (LONG64)bkTop)
+			break;
+	}
+	*pDestChunk = popNode;
+
+	return true;
+}
+
+template <class T, size_t ChunkSize>
+bool SharedMemoryPool<T, ChunkSize>::PopBlock(volatile UINT64* pTop, BLOCK** pDestBlock)
+{
+	UINT64 bkTop;
+	volatile UINT64 idx;
+	BLOCK* popNode;
+	UINT64 nextTop;
+	while (1)
+	{
+		bkTop = *pTop;
+		idx = (bkTop >> 47) + 1;
+		popNode = ToPtr<BLOCK>(bkTop & 0x00007FFFFFFFFFFF);
+		if (popNode == nullptr)
+			return false;
+
+		nextTop = *(volatile UINT64*)&popNode->_next;
+
+		if (InterlockedCompareExchange64((PLONG64)pTop, (LONG64)(nextTop | (idx << 47)), (LONG64)bkTop) == (LONG64)bkTop)
+			break;
+	}
+	*pDestBlock = popNode;
+
+	return true;
+}
@@ -0,0 +1,184 @@
+/*
+# PoolRegistryBench
+
+庰 Chunk ĳø ã θ ٲ  Alloc/Free
+PoolRegistry::GetCache/SetCache TlsGetValue/TlsSetValue  մϴ.
+  MemoryPoolTLS Alloc/Free Բ մϴ.
+
+PoolRegistryBench [threadNum] [opNumPerThread]
+	threadNum		:   (⺻ 4)
+	opNumPerThread	: 帶  Alloc/Free  (⺻ 10000000)
+
+- Ǯ (1, 8, 64)ŭ Ǯ  긶 Ǯ  
+- Chunk ũ⸸ŭ Alloc   FreeϹǷ ĳ ȸ Chunk  Push/Pop ݺ
+-   ns/op(Alloc, Free   1ȸ )
+*/
+#define MEMORYPOOL_MODE_RELEASE
+#include "../MemoryPoolTLS/MemoryPoolTLS.h"
+#include "../BenchHarness/BenchHarness.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#define DEFAULT_THREAD_NUM	4
+#define DEFAULT_OP_NUM		10000000
+#define BENCH_CHUNK_SIZE	NUM_OF_BLOCK_IN_CHUNK
+#define MAX_POOL_NUM		64
+
+struct PAYLOAD
+{
+	BYTE	_data[64];
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+/* Cache lookup */
+class TlsSlotCache
+{
+public:
+	TlsSlotCache()
+	{
+		_tlsIdx = TlsAlloc();
+		if (_tlsIdx == TLS_OUT_OF_INDEXES)
+			throw GetLastError();
+	}
+	~TlsSlotCache() { TlsFree(_tlsIdx); }
+	void* Get() { return TlsGetValue(_tlsIdx); }
+	void Set(void* pCache) { TlsSetValue(_tlsIdx, pCache); }
+private:
+	DWORD	_tlsIdx;
+};
+
+class RegistryCache
+{
+public:
+	RegistryCache() { _key = PoolRegistry::Acquire(this, Release); }
+	~RegistryCache() { PoolRegistry::Release(_key); }
+	void* Get() { return PoolRegistry::GetCache(_key); }
+	void Set(void* pCache) { PoolRegistry::SetCache(_key, pCache); }
+private:
+	static void Release(void* pOwner, void* pCache) {}
+private:
+	poolkey_t	_key;
+};
+
+// MemoryPoolTLS Chunk ο ĳ ȸ ĸ ٲ Ǯ
+template <class Cache>
+class BenchPool
+{
+private:
+	struct CHUNK
+	{
+		PAYLOAD*	_blocks[BENCH_CHUNK_SIZE];
+		UINT64		_size;
+	};
+public:
+	~BenchPool()
+	{
+		for (CHUNK* pChunk : _chunks)
+		{
+			for (UINT64 i = 0; i < pChunk->_size; i++)
+				delete pChunk->_blocks[i];
+			delete pChunk;
+		}
+	}
+	PAYLOAD* Alloc()
+	{
+		CHUNK* pChunk = reinterpret_cast<CHUNK*>(_cache.Get());
+		if (pChunk == nullptr)
+			pChunk = NewChunk();
+		if (pChunk->_size == 0)
+			return nullptr;
+		return pChunk->_blocks[--pChunk->_size];
+	}
+	void Free(PAYLOAD* pData)
+	{
+		CHUNK* pChunk = reinterpret_cast<CHUNK*>(_cache.Get());
+		pChunk->_blocks[pChunk->_size++] = pData;
+	}
+private:
+	CHUNK* NewChunk()
+	{
+		CHUNK* pChunk = new CHUNK;
+		for (UINT64 i = 0; i < BENCH_CHUNK_SIZE; i++)
+			pChunk->_blocks[i] = new PAYLOAD;
+		pChunk->_size = BENCH_CHUNK_SIZE;
+		_cache.Set(pChunk);
+
+		AcquireSRWLockExclusive(&_lock);
+		_chunks.push_back(pChunk);
+		ReleaseSRWLockExclusive(&_lock);
+		return pChunk;
+	}
+private:
+	Cache				_cache;
+	SRWLOCK				_lock = SRWLOCK_INIT;
+	std::vector<CHUNK*>	_chunks;
+};
+
+class PoolTLS
+{
+public:
+	PoolTLS() :_pool(0, POOL_MAX_ALLOC, false) {}
+	PAYLOAD* Alloc() { return _pool.Alloc(); }
+	void Free(PAYLOAD* pData) { _pool.Free(pData); }
+private:
+	MemoryPoolTLS<PAYLOAD, BENCH_CHUNK_SIZE> _pool;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+template <class Pool>
+static double Run(UINT32 threadNum, UINT64 opNum, UINT32 poolNum)
+{
+	std::vector<Pool*> pools;
+	for (UINT32 i = 0; i < poolNum; i++)
+		pools.push_back(new Pool);
+
+	double elapsedSec = RunBenchThreads(threadNum,
+		[&](UINT32 threadIdx)
+		{
+			// Chunk Ҵ  
+			for (UINT32 poolIdx = 0; poolIdx < poolNum; poolIdx++)
+				pools[poolIdx]->Free(pools[poolIdx]->Alloc());
+		},
+		[&](UINT32 threadIdx)
+		{
+			PAYLOAD* ptrs[BENCH_CHUNK_SIZE];
+			for (UINT64 i = 0; i < opNum; i += BENCH_CHUNK_SIZE)
+			{
+				for (UINT32 j = 0; j < BENCH_CHUNK_SIZE; j++)
+					ptrs[j] = pools[j % poolNum]->Alloc();
+				for (UINT32 j = 0; j < BENCH_CHUNK_SIZE; j++)
+					pools[j % poolNum]->Free(ptrs[j]);
+			}
+		});
+
+	for (Pool* pPool : pools)
+		delete pPool;
+
+	UINT64 totalOpNum = (opNum + BENCH_CHUNK_SIZE - 1) / BENCH_CHUNK_SIZE * BENCH_CHUNK_SIZE * 2;
+	return elapsedSec * 1000000000.0 / totalOpNum;
+}
+
+int main(int argc, char* argv[])
+{
+	UINT32 threadNum = argc > 1 ? (UINT32)strtoul(argv[1], nullptr, 10) : DEFAULT_THREAD_NUM;
+	UINT64 opNum = argc > 2 ? strtoull(argv[2], nullptr, 10) : DEFAULT_OP_NUM;
+	if (threadNum == 0 || opNum == 0)
+	{
+		printf("Usage: %s [threadNum] [opNumPerThread]\n", argv[0]);
+		return 1;
+	}
+
+	printf("Threads         : %u\n", threadNum);
+	printf("Ops per thread  : %llu (Alloc + Free pairs)\n", opNum);
+	printf("Latency         : ns/op per thread\n\n");
+	printf("%8s %14s %14s %14s\n", "Pools", "TlsGetValue", "PoolRegistry", "MemoryPoolTLS");
+	for (UINT32 poolNum = 1; poolNum <= MAX_POOL_NUM; poolNum *= 8)
+	{
+		printf("%8u %14.2f %14.2f %14.2f\n", poolNum,
+			Run<BenchPool<TlsSlotCache>>(threadNum, opNum, poolNum),
+			Run<BenchPool<RegistryCache>>(threadNum, opNum, poolNum),
+			Run<PoolTLS>(threadNum, opNum, poolNum));
+	}
+	return 0;
+}